@@ -0,0 +1,28 @@
+#version 430 core
+
+layout (location = 0) in vec2 aTransformedX;
+layout (location = 1) in vec2 aTransformedY;
+layout (location = 2) in vec3 aTranslation;
+layout (location = 3) in vec4 aTextureRect;
+layout (location = 4) in vec4 aColor;
+layout (location = 5) in uint aTexIndex;
+
+out vec4 fragmentColor;
+out vec3 fragmentPosition;
+out vec2 texCoords;
+flat out uint texIndex;
+
+uniform mat4 projectionMatrix;
+
+const vec2 corners[4] = vec2[](vec2(-1.0, -1.0), vec2(1.0, -1.0), vec2(1.0, 1.0), vec2(-1.0, 1.0));
+
+void main() {
+   vec2 corner = corners[gl_VertexID];
+   vec3 worldPosition = vec3(aTransformedX * corner.x + aTransformedY * corner.y, 0.0) + aTranslation;
+   vec4 position = projectionMatrix * vec4(worldPosition, 1.0);
+   fragmentPosition = position.xyz;
+   fragmentColor = aColor;
+   texCoords = mix(aTextureRect.xy, aTextureRect.zw, (corner + 1.0) * 0.5);
+   texIndex = aTexIndex;
+   gl_Position = position;
+}
\ No newline at end of file
@@ -0,0 +1,88 @@
+//
+// Created by coder2k on 09.12.2021.
+//
+
+#include <Registry.hpp>
+#include <benchmark/benchmark.h>
+#include <range/v3/all.hpp>
+
+using namespace c2k;
+
+namespace {
+
+    struct Position {
+        float x{ 0.0f }, y{ 0.0f };
+    };
+
+    struct Velocity {
+        float x{ 0.0f }, y{ 0.0f };
+    };
+
+    // every fourth entity has no velocity so that the iteration has to skip entities
+    void populate(Registry& registry, std::size_t count) {
+        for (std::size_t i = 0; i < count; ++i) {
+            const auto value = static_cast<float>(i);
+            if (i % 4 == 0) {
+                registry.createEntity(Position{ value, value });
+            } else {
+                registry.createEntity(Position{ value, value }, Velocity{ 1.0f, -1.0f });
+            }
+        }
+    }
+
+    void RangesPipeline(benchmark::State& state) {
+        Registry registry;
+        populate(registry, static_cast<std::size_t>(state.range(0)));
+        for (auto _ : state) {
+            for (auto&& [entity, position, velocity] : registry.componentsMutable<Position, Velocity>()) {
+                position.x += velocity.x;
+                position.y += velocity.y;
+            }
+            benchmark::ClobberMemory();
+        }
+    }
+
+    void Each(benchmark::State& state) {
+        Registry registry;
+        populate(registry, static_cast<std::size_t>(state.range(0)));
+        for (auto _ : state) {
+            registry.each<Position, Velocity>([](Entity entity, Position& position, const Velocity& velocity) {
+                benchmark::DoNotOptimize(entity);
+                position.x += velocity.x;
+                position.y += velocity.y;
+            });
+            benchmark::ClobberMemory();
+        }
+    }
+
+    void EachWithoutEntities(benchmark::State& state) {
+        Registry registry;
+        populate(registry, static_cast<std::size_t>(state.range(0)));
+        for (auto _ : state) {
+            registry.each<Position, Velocity>([](Position& position, const Velocity& velocity) {
+                position.x += velocity.x;
+                position.y += velocity.y;
+            });
+            benchmark::ClobberMemory();
+        }
+    }
+
+    void EachOwningGroup(benchmark::State& state) {
+        Registry registry;
+        registry.registerGroup<Position, Velocity>();
+        populate(registry, static_cast<std::size_t>(state.range(0)));
+        for (auto _ : state) {
+            registry.each<Position, Velocity>([](Position& position, const Velocity& velocity) {
+                position.x += velocity.x;
+                position.y += velocity.y;
+            });
+            benchmark::ClobberMemory();
+        }
+    }
+
+}// namespace
+
+BENCHMARK(RangesPipeline)->Range(1 << 10, 1 << 18);
+BENCHMARK(Each)->Range(1 << 10, 1 << 18);
+BENCHMARK(EachWithoutEntities)->Range(1 << 10, 1 << 18);
+BENCHMARK(EachOwningGroup)->Range(1 << 10, 1 << 18);
@@ -0,0 +1,73 @@
+//
+// Created by coder2k on 13.12.2021.
+//
+
+#include <Renderer.hpp>
+#include <RecordingRenderBackend.hpp>
+#include <QuadVertexKernel.hpp>
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <utility>
+#include <vector>
+
+using namespace c2k;
+
+namespace {
+
+    constexpr WindowSize framebufferSize{ 1920, 1080 };
+    constexpr int numTextures = 8;
+
+    [[nodiscard]] glm::mat4 transformOfQuad(std::size_t index) {
+        const auto value = static_cast<float>(index);
+        return glm::scale(glm::rotate(glm::translate(glm::mat4{ 1.0f }, glm::vec3{ value, -value, 0.0f }), value,
+                                      glm::vec3{ 0.0f, 0.0f, 1.0f }),
+                          glm::vec3{ 16.0f, 16.0f, 1.0f });
+    }
+
+    void QuadVertexGeneration(benchmark::State& state) {
+        const auto numQuads = static_cast<std::size_t>(state.range(0));
+        QuadBatch quads{ numQuads };
+        for (std::size_t i = 0; i < numQuads; ++i) {
+            quads.add(transformOfQuad(i), Rect::unit(), 0xFFFFFFFFU, static_cast<GLushort>(i % numTextures));
+        }
+        std::vector<QuadVertex> vertices(numQuads * 4);
+        for (auto _ : state) {
+            generateQuadVertices(quads, vertices);
+            benchmark::DoNotOptimize(vertices.data());
+            benchmark::ClobberMemory();
+        }
+        state.counters["vertices"] = benchmark::Counter(static_cast<double>(numQuads * 4),
+                                                        benchmark::Counter::kIsIterationInvariantRate);
+    }
+
+    // includes sorting, batching and the copies made by the recording backend
+    void RendererFrame(benchmark::State& state) {
+        const auto numQuads = static_cast<std::size_t>(state.range(0));
+        auto backend = std::make_unique<RecordingRenderBackend>();
+        auto& recordingBackend = *backend;
+        Renderer renderer{ std::move(backend) };
+        auto& shader = recordingBackend.createShaderProgram();
+        std::vector<const Texture*> textures;
+        for (int i = 0; i < numTextures; ++i) {
+            textures.push_back(&recordingBackend.createTexture());
+        }
+        std::vector<glm::mat4> transforms;
+        for (std::size_t i = 0; i < numQuads; ++i) {
+            transforms.push_back(transformOfQuad(i));
+        }
+        for (auto _ : state) {
+            renderer.beginFrame(glm::mat4{ 1.0f }, framebufferSize);
+            for (std::size_t i = 0; i < numQuads; ++i) {
+                renderer.drawQuad(transforms[i], shader, *textures[i % textures.size()]);
+            }
+            renderer.endFrame();
+            recordingBackend.clearRecording();
+        }
+        state.counters["vertices"] = benchmark::Counter(static_cast<double>(numQuads * 4),
+                                                        benchmark::Counter::kIsIterationInvariantRate);
+    }
+
+}// namespace
+
+BENCHMARK(QuadVertexGeneration)->Range(1 << 10, 1 << 16);
+BENCHMARK(RendererFrame)->Range(1 << 10, 1 << 16);
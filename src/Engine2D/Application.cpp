@@ -12,6 +12,7 @@
 #include <imgui_impl_glfw.h>
 #include <imgui_impl_opengl3.h>
 #include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <variant>
 
@@ -57,7 +58,8 @@ namespace c2k {
     Application::Application(const std::string& title, c2k::WindowSize size, c2k::OpenGLVersion version) noexcept
         : mWindow{ title, size, version, mInput },
           mRenderer{ mWindow },
-          mAppContext{ mRenderer, mRegistry, mTime, mInput, mAssetDatabase, *this, invalidEntity } {
+          mAppContext{ mRenderer, mRegistry, mTime, mInput, mAssetDatabase, *this, mCommandBuffers, invalidEntity } {
+        mRegistry.setJobSystem(&mJobSystem);
         mAppContext.mainCameraEntity = mRegistry.createEntity(TransformComponent{}, CameraComponent{});
     }
 
@@ -72,6 +74,7 @@ namespace c2k {
         spdlog::info("This is the release build");
 #endif
         registerComponentTypes();
+        registerSystems();
         setup();
         auto timeMeasurements = setupTimeMeasurements();
         while (!glfwWindowShouldClose(mWindow.getGLFWWindowPointer())) {
@@ -88,6 +91,7 @@ namespace c2k {
 
             glfwSwapBuffers(mWindow.getGLFWWindowPointer());
             mInput.nextFrame();
+            mRegistry.clearChanges();
             glfwPollEvents();
             makeTimeMeasurementsStep(timeMeasurements, mTime);
             refreshWindowTitle();
@@ -99,16 +103,14 @@ namespace c2k {
     }
 
     void Application::runSystems() noexcept {
-        runScripts();
-        animateSprites();
-        handleParticleEmitters();
-        handleParticles();
-        renderDynamicSprites();
+        mSystemScheduler.run();
     }
 
     void Application::animateSprites() noexcept {
-        for (auto&& [entity, animation, dynamicSprite] :
-             mRegistry.componentsMutable<SpriteSheetAnimationComponent, DynamicSpriteComponent>()) {
+        const auto animate = [this](Entity entity, auto& animation, auto& dynamicSprite) {
+            if (mRegistry.hasComponent<ParticleComponent>(entity)) {
+                return;// particles are owned by handleParticles() which may run at the same time
+            }
             const auto& animationAsset = *animation.animation;
             bool advanceFrame = false;
             double nextFrameChange = 0.0;
@@ -137,17 +139,15 @@ namespace c2k {
                 dynamicSprite.sprite.textureRect = animation.spriteSheet->frames[animation.currentFrame].rect;
                 animation.lastFrameChange = nextFrameChange;
             }
-        }
+        };
+        mRegistry.parallelEach<SpriteSheetAnimationComponent, DynamicSpriteComponent>(animate);
     }
 
     void Application::runScripts() noexcept {
         for (auto&& [entity, scriptComponent] : mRegistry.components<ScriptComponent>()) {
             scriptComponent.script->invokeUpdate(entity);
         }
-        for (const auto& command : mAppContext.bufferedScriptCommands) {
-            std::visit([this](auto&& typedCommand) { typedCommand.process(mAppContext); }, command);
-        }
-        mAppContext.bufferedScriptCommands.clear();
+        mCommandBuffers.playback(mRegistry);
     }
 
     void Application::renderDynamicSprites() noexcept {
@@ -155,9 +155,16 @@ namespace c2k {
                 mRegistry.component<TransformComponent>(mAppContext.mainCameraEntity)->matrix();
         mRenderer.clear(true, true);
         mRenderer.beginFrame(cameraTransformMatrix);
-        for (auto&& [entity, dynamicSprite, transform] :
-             mRegistry.components<DynamicSpriteComponent, TransformComponent>()) {
-            mRenderer.drawQuad(EntityUtils::getGlobalTransform(mRegistry, entity), *dynamicSprite.shaderProgram,
+        // the sprites stay nearly sorted between frames, so this is much cheaper than sorting the render commands
+        mRegistry.sort<DynamicSpriteComponent>(
+                [](const DynamicSpriteComponent& lhs, const DynamicSpriteComponent& rhs) {
+                    return Renderer::isDrawnBefore(*lhs.shaderProgram, *lhs.sprite.texture, lhs.color,
+                                                   *rhs.shaderProgram, *rhs.sprite.texture, rhs.color);
+                },
+                SortAlgorithm::Insertion);
+        for (auto&& [entity, dynamicSprite, transform, worldTransform] :
+             mRegistry.group<DynamicSpriteComponent, TransformComponent, WorldTransformComponent>()) {
+            mRenderer.drawQuad(worldTransform.matrix, *dynamicSprite.shaderProgram,
                                *dynamicSprite.sprite.texture, dynamicSprite.sprite.textureRect, dynamicSprite.color);
         }
         mRenderer.endFrame();
@@ -174,15 +181,35 @@ namespace c2k {
     }
 
     void Application::registerComponentTypes() noexcept {
-        mRegistry.registerType<RootComponent>();
-        mRegistry.registerType<RelationshipComponent>();
-        mRegistry.registerType<TransformComponent>();
-        mRegistry.registerType<DynamicSpriteComponent>();
-        mRegistry.registerType<SpriteSheetAnimationComponent>();
-        mRegistry.registerType<CameraComponent>();
-        mRegistry.registerType<ScriptComponent>();
-        mRegistry.registerType<ParticleEmitterComponent>();
-        mRegistry.registerType<ParticleComponent>();
+        mRegistry.registerTypes(EngineComponentTypes{});
+        mRegistry.registerGroup<DynamicSpriteComponent, TransformComponent, WorldTransformComponent>();
+        mParticleEmittersQuery =
+                mRegistry.registerQuery<ParticleEmitterComponent, TransformComponent, RootComponent>();
+    }
+
+    void Application::registerSystems() noexcept {
+        // conflicting systems run in this order, the others may run concurrently
+        mSystemScheduler.addSystem("runScripts", SystemAccess{}.exclusive(), [this] { runScripts(); });
+        mSystemScheduler.addSystem("handleParticleEmitters", SystemAccess{}.exclusive(),
+                                   [this] { handleParticleEmitters(); });
+        mSystemScheduler.addSystem("animateSprites",
+                                   SystemAccess{}
+                                           .writes<SpriteSheetAnimationComponent, DynamicSpriteComponent>()
+                                           .with<SpriteSheetAnimationComponent, DynamicSpriteComponent>()
+                                           .without<ParticleComponent>(),
+                                   [this] { animateSprites(); });
+        mSystemScheduler.addSystem("handleParticles",
+                                   SystemAccess{}
+                                           .writes<ParticleComponent, DynamicSpriteComponent, TransformComponent>()
+                                           .writes<ParticleEmitterComponent>()
+                                           .with<ParticleComponent, DynamicSpriteComponent, TransformComponent>(),
+                                   [this] { handleParticles(); });
+        mSystemScheduler.addSystem("playbackCommandBuffers", SystemAccess{}.exclusive(),
+                                   [this] { playbackCommandBuffers(); });
+        mSystemScheduler.addSystem("updateWorldTransforms", SystemAccess{}.exclusive(),
+                                   [this] { EntityUtils::updateWorldTransforms(mRegistry); });
+        mSystemScheduler.addSystem("renderDynamicSprites", SystemAccess{}.exclusive(),
+                                   [this] { renderDynamicSprites(); });
     }
 
     template<typename T>
@@ -273,8 +300,7 @@ namespace c2k {
         /* find all the particle emitters that should spawn at least one particle within the
            current frame and save them into mSpawningEmitters (they are saved multiple times
            if they should spawn more than one particle */
-        for (auto&& [entity, particleEmitter, transform, root] :
-             mRegistry.componentsMutable<ParticleEmitterComponent, TransformComponent, RootComponent>()) {
+        for (auto&& [entity, particleEmitter, transform, root] : mRegistry.queryMutable(mParticleEmittersQuery)) {
             const auto particleSystem = particleEmitter.particleSystem;
             const double startDelay = getTwoWaySelectorValue<double>(particleSystem->startDelay, mRandom);
             bool shouldSpawnParticle = particleEmitter.currentDuration >= startDelay;
@@ -394,46 +420,59 @@ namespace c2k {
     }
 
     void Application::handleParticles() noexcept {
-        auto entityRange = mRegistry.componentsMutable<ParticleComponent, DynamicSpriteComponent, TransformComponent>();
-        std::for_each(std::execution::par, entityRange.begin(), entityRange.end(), [&](auto&& tuple) {
-            auto&& [entity, particle, sprite, transform] = tuple;
+        const auto updateParticle = [this](Entity entity, auto& particle, auto& sprite, auto& transform) {
+            // the random engine is not thread safe, so every worker thread gets its own one
+            thread_local Random random;
             const auto& particleSystem = *particle.particleSystem;
             const float interpolationParameter =
                     gsl::narrow_cast<float>(1.0 - particle.remainingLifeTime / particle.totalLifeTime);
             const auto delta = gsl::narrow_cast<float>(mTime.delta);
-            const auto velocityValue = getFourWaySelectorValueVec2(particleSystem.linearVelocityOverLifetime, mRandom,
+            const auto velocityValue = getFourWaySelectorValueVec2(particleSystem.linearVelocityOverLifetime, random,
                                                                    particle.totalLifeTime,
                                                                    particle.totalLifeTime - particle.remainingLifeTime);
             const auto velocity = glm::vec3{ velocityValue.x, velocityValue.y, 0.0f };
-            particle.velocityFromGravity += particle.gravity * delta;
             transform.position += delta * (velocity + particle.velocityFromGravity + particle.startVelocity);
             if (particleSystem.sizeOverLifetime.has_value()) {
                 transform.scale = particle.baseScale *
                                   ImGui::BezierValue(interpolationParameter, particleSystem.sizeOverLifetime.value());
             }
             transform.rotation += glm::radians(getFourWaySelectorValue<float>(
-                                          particleSystem.radialVelocityOverLifetime, mRandom, particle.totalLifeTime,
+                                          particleSystem.radialVelocityOverLifetime, random, particle.totalLifeTime,
                                           particle.totalLifeTime - particle.remainingLifeTime)) *
                                   delta;
             if (particleSystem.colorOverLifetime) {
                 sprite.color = getGradientColor(particleSystem.colorOverLifetime.value(), interpolationParameter);
             }
             particle.remainingLifeTime -= mTime.delta;
-        });
-        for (auto&& [entity, particle, sprite, transform] : entityRange) {
             if (particle.remainingLifeTime < 0.0) {
-                mParticleEntitiesToDelete.emplace_back(entity);
+                const auto emitterEntity = particle.particleEmitterEntity;
+                if (mRegistry.isEntityAlive(emitterEntity)) {
+                    // multiple particles of the same emitter may expire concurrently
+                    auto& emitter = mRegistry.componentMutable<ParticleEmitterComponent>(emitterEntity).value();
+                    std::atomic_ref{ emitter.numParticles }.fetch_sub(1, std::memory_order_relaxed);
+                }
+                auto& commands = mCommandBuffers.local();
+                commands.setSortKey(entity);
+                commands.destroyEntity(entity);
             }
+        };
+        // gravity is integrated in a separate pass that only streams through the two involved columns
+        const auto delta = gsl::narrow_cast<float>(mTime.delta);
+        const auto gravities = mRegistry.column<&ParticleComponent::gravity>();
+        const auto velocitiesFromGravity = mRegistry.columnMutable<&ParticleComponent::velocityFromGravity>();
+        for (std::size_t i = 0; i < velocitiesFromGravity.size(); ++i) {
+            velocitiesFromGravity[i] += gravities[i] * delta;
         }
-        for (auto entityToDelete : mParticleEntitiesToDelete) {
-            const auto emitterEntity = mRegistry.component<ParticleComponent>(entityToDelete)->particleEmitterEntity;
-            if (mRegistry.isEntityAlive(emitterEntity)) {
-                auto& emitter = mRegistry.componentMutable<ParticleEmitterComponent>(emitterEntity).value();
-                --emitter.numParticles;
-            }
-            mRegistry.destroyEntity(entityToDelete);
+        mRegistry.parallelEach<ParticleComponent, DynamicSpriteComponent, TransformComponent>(updateParticle);
+        // the transforms have been modified concurrently, so the changes can only be reported afterwards
+        if (mRegistry.isChangeTrackingEnabled<TransformComponent>()) {
+            mRegistry.each<ParticleComponent, TransformComponent>(
+                    [this](const Entity entity, auto&&, auto&&) { mRegistry.markUpdated<TransformComponent>(entity); });
         }
-        mParticleEntitiesToDelete.clear();
+    }
+
+    void Application::playbackCommandBuffers() noexcept {
+        mCommandBuffers.playback(mRegistry);
     }
 
 }// namespace c2k
\ No newline at end of file
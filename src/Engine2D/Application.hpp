@@ -16,6 +16,9 @@
 #include "Renderer.hpp"
 #include "Time.hpp"
 #include "Random.hpp"
+#include "CommandBuffer.hpp"
+#include "JobSystem.hpp"
+#include "SystemScheduler.hpp"
 
 namespace c2k {
 
@@ -52,8 +55,10 @@ namespace c2k {
         void spawnParticles() noexcept;
         void handleParticleEmitters() noexcept;
         void handleParticles() noexcept;
+        void playbackCommandBuffers() noexcept;
         void refreshWindowTitle() noexcept;
         void registerComponentTypes() noexcept;
+        void registerSystems() noexcept;
 
     protected:
         Input mInput;
@@ -63,11 +68,14 @@ namespace c2k {
         Time mTime;
         AssetDatabase mAssetDatabase;
         Random mRandom;
+        CommandBuffers mCommandBuffers;
         ApplicationContext mAppContext;
+        JobSystem mJobSystem;
+        SystemScheduler mSystemScheduler{ mJobSystem };// also provides the timings of all systems
 
     private:
         std::vector<Entity> mSpawningEmitters;
-        std::vector<Entity> mParticleEntitiesToDelete;
+        Query<ParticleEmitterComponent, TransformComponent, RootComponent> mParticleEmittersQuery;
     };
 
 }// namespace c2k
\ No newline at end of file
@@ -13,6 +13,7 @@ namespace c2k {
                                            Input& input,
                                            AssetDatabase& assetDatabase,
                                            Application& application,
+                                           CommandBuffers& commandBuffers,
                                            Entity mainCameraEntity) noexcept
         : renderer{ renderer },
           registry{ registry },
@@ -20,6 +21,7 @@ namespace c2k {
           input{ input },
           assetDatabase{ assetDatabase },
           application{ application },
+          commandBuffers{ commandBuffers },
           mainCameraEntity{ mainCameraEntity } {
         Script::setApplicationContext(*this);
     }
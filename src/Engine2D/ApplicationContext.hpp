@@ -5,8 +5,6 @@
 #pragma once
 
 #include "Entity.hpp"
-#include "BufferedScriptCommand.hpp"
-#include <vector>
 
 namespace c2k {
 
@@ -16,6 +14,7 @@ namespace c2k {
     class Input;
     class AssetDatabase;
     class Application;
+    class CommandBuffers;
 
     struct ApplicationContext {
         ApplicationContext(Renderer& renderer,
@@ -24,6 +23,7 @@ namespace c2k {
                            Input& input,
                            AssetDatabase& assetDatabase,
                            Application& application,
+                           CommandBuffers& commandBuffers,
                            Entity mainCameraEntity) noexcept;
 
         Renderer& renderer;
@@ -32,8 +32,8 @@ namespace c2k {
         Input& input;
         AssetDatabase& assetDatabase;
         Application& application;
+        CommandBuffers& commandBuffers;// structural changes requested by scripts are deferred
         Entity mainCameraEntity;
-        std::vector<BufferedScriptCommands::Command> bufferedScriptCommands;
     };
 
 }// namespace c2k
\ No newline at end of file
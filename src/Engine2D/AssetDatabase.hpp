@@ -141,6 +141,15 @@ namespace c2k {
             return get<Animation>(guid, mDebugFallbackAnimation);
         }
 
+        // can be used as an AssetResolver when restoring registry snapshots
+        [[nodiscard]] void* assetAddress(GUID guid) noexcept {
+            const auto it = mAssets.find(guid);
+            if (it == mAssets.end()) {
+                return nullptr;
+            }
+            return std::visit([](auto& asset) -> void* { return &asset; }, it->second);
+        }
+
         static void setAssetPath(std::filesystem::path path) noexcept {
             sAssetPath = std::move(path);
         }
@@ -0,0 +1,40 @@
+//
+// Created by coder2k on 10.12.2021.
+//
+
+#include "ChangeTracker.hpp"
+
+namespace c2k {
+
+    void ChangeTracker::clear() noexcept {
+        for (const auto identifier : mTouchedSlots) {
+            mSlots[identifier] = Slot{};
+        }
+        mTouchedSlots.clear();
+        mAdded.clear();
+        mRemoved.clear();
+        mUpdated.clear();
+    }
+
+    void ChangeTracker::record(std::vector<Entity>& list,
+                               std::size_t identifier,
+                               Entity entity,
+                               std::uint8_t flag) noexcept {
+        if (identifier >= mSlots.size()) {
+            mSlots.resize(identifier + 1);
+        }
+        auto& slot = mSlots[identifier];
+        if (slot.entity != entity) {
+            if (slot.entity == invalidEntity) {
+                mTouchedSlots.push_back(identifier);
+            }
+            slot = Slot{ .entity{ entity }, .flags{ 0 } };
+        }
+        if ((slot.flags & flag) != 0) {
+            return;
+        }
+        slot.flags = static_cast<std::uint8_t>(slot.flags | flag);
+        list.push_back(entity);
+    }
+
+}// namespace c2k
\ No newline at end of file
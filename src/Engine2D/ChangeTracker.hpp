@@ -0,0 +1,74 @@
+//
+// Created by coder2k on 10.12.2021.
+//
+
+#pragma once
+
+#include "Entity.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace c2k {
+
+    /* Records the entities whose component of a single type has been added, removed or updated since the
+     * last call to clear() (which happens once per frame). Each entity appears at most once per list, so
+     * incremental systems can pull compact lists instead of visiting all entities. The lists are not
+     * reconciled: a component that has been added and removed within the same frame is part of both. */
+    class ChangeTracker final {
+    public:
+        void recordAdded(std::size_t identifier, Entity entity) noexcept {
+            record(mAdded, identifier, entity, addedFlag);
+        }
+
+        void recordRemoved(std::size_t identifier, Entity entity) noexcept {
+            record(mRemoved, identifier, entity, removedFlag);
+        }
+
+        void recordUpdated(std::size_t identifier, Entity entity) noexcept {
+            record(mUpdated, identifier, entity, updatedFlag);
+        }
+
+        [[nodiscard]] std::span<const Entity> added() const noexcept {
+            return mAdded;
+        }
+
+        // the entities may not be alive anymore
+        [[nodiscard]] std::span<const Entity> removed() const noexcept {
+            return mRemoved;
+        }
+
+        [[nodiscard]] std::span<const Entity> updated() const noexcept {
+            return mUpdated;
+        }
+
+        [[nodiscard]] bool empty() const noexcept {
+            return mAdded.empty() && mRemoved.empty() && mUpdated.empty();
+        }
+
+        // only touches the entries that have been recorded since the last call
+        void clear() noexcept;
+
+    private:
+        static constexpr std::uint8_t addedFlag = 1 << 0;
+        static constexpr std::uint8_t removedFlag = 1 << 1;
+        static constexpr std::uint8_t updatedFlag = 1 << 2;
+
+        struct Slot {
+            Entity entity{ invalidEntity };// identifiers can be recycled within a frame
+            std::uint8_t flags{ 0 };
+        };
+
+    private:
+        void record(std::vector<Entity>& list, std::size_t identifier, Entity entity, std::uint8_t flag) noexcept;
+
+    private:
+        std::vector<Slot> mSlots;// indexed by entity identifier
+        std::vector<std::size_t> mTouchedSlots;
+        std::vector<Entity> mAdded;
+        std::vector<Entity> mRemoved;
+        std::vector<Entity> mUpdated;
+    };
+
+}// namespace c2k
\ No newline at end of file
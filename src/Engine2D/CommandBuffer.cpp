@@ -0,0 +1,144 @@
+//
+// Created by coder2k on 06.12.2021.
+//
+
+#include "CommandBuffer.hpp"
+#include <algorithm>
+
+namespace c2k {
+
+    CommandBuffer::~CommandBuffer() noexcept {
+        destructPayloads();
+    }
+
+    void CommandBuffer::clear() noexcept {
+        destructPayloads();
+        mCommands.clear();
+        mCurrentBlock = 0;
+        mBlockOffset = 0;
+        mSortKey = 0;
+    }
+
+    void* CommandBuffer::allocate(std::size_t size, std::size_t alignment) noexcept {
+        assert(size <= arenaBlockSize && "Component too big for the command buffer.");
+        while (true) {
+            if (mCurrentBlock == mArenaBlocks.size()) {
+                mArenaBlocks.push_back(std::make_unique_for_overwrite<std::byte[]>(arenaBlockSize));
+                mBlockOffset = 0;
+            }
+            const auto offset = (mBlockOffset + alignment - 1) / alignment * alignment;
+            if (offset + size <= arenaBlockSize) {
+                mBlockOffset = offset + size;
+                return mArenaBlocks[mCurrentBlock].get() + offset;
+            }
+            ++mCurrentBlock;
+            mBlockOffset = 0;
+        }
+    }
+
+    void CommandBuffer::apply(const Command& command, Registry& registry) const noexcept {
+        switch (command.type) {
+            case CommandType::CreateEntity: {
+                const auto entity = registry.createEntity();
+                for (std::size_t i = 0; i < command.numComponents; ++i) {
+                    command.components[i].operations->attach(registry, entity, command.components[i].component);
+                }
+                break;
+            }
+            case CommandType::DestroyEntity:
+                if (registry.isEntityAlive(command.entity)) {
+                    registry.destroyEntity(command.entity);
+                }
+                break;
+            case CommandType::AttachComponent:
+                if (registry.isEntityAlive(command.entity)) {
+                    command.components->operations->attach(registry, command.entity, command.components->component);
+                }
+                break;
+            case CommandType::RemoveComponent:
+                if (registry.isEntityAlive(command.entity)) {
+                    command.components->operations->remove(registry, command.entity);
+                }
+                break;
+        }
+    }
+
+    void CommandBuffer::destructPayloads() noexcept {
+        for (const auto& command : mCommands) {
+            for (std::size_t i = 0; i < command.numComponents; ++i) {
+                if (command.components[i].component != nullptr) {
+                    command.components[i].operations->destruct(command.components[i].component);
+                }
+            }
+        }
+    }
+
+    CommandBuffers::CommandBuffers() noexcept : mIdentifier{ sNextIdentifier++ } { }
+
+    CommandBuffer& CommandBuffers::local() noexcept {
+        if (sLocalBufferCache.ownerIdentifier == mIdentifier) {
+            return *sLocalBufferCache.buffer;
+        }
+        std::scoped_lock lock{ mMutex };
+        const auto threadId = std::this_thread::get_id();
+        auto it = std::find_if(mThreadBuffers.begin(), mThreadBuffers.end(),
+                               [threadId](const auto& threadBuffer) { return threadBuffer.threadId == threadId; });
+        if (it == mThreadBuffers.end()) {
+            mBuffers.push_back(std::make_unique<CommandBuffer>());
+            mThreadBuffers.push_back(ThreadBuffer{ .threadId{ threadId }, .buffer{ mBuffers.back().get() } });
+            it = std::prev(mThreadBuffers.end());
+        }
+        sLocalBufferCache = LocalBufferCache{ .ownerIdentifier{ mIdentifier }, .buffer{ it->buffer } };
+        return *it->buffer;
+    }
+
+    void CommandBuffers::playback(Registry& registry) noexcept {
+        std::scoped_lock lock{ mMutex };
+        // the buffers are visited in order of their creation, so the main thread usually comes first
+        for (const auto& buffer : mBuffers) {
+            for (const auto& command : buffer->mCommands) {
+                mPendingCommands.push_back(
+                        PendingCommand{ .sortKey{ command.sortKey }, .buffer{ buffer.get() }, .command{ &command } });
+            }
+        }
+        std::stable_sort(mPendingCommands.begin(), mPendingCommands.end(),
+                         [](const auto& lhs, const auto& rhs) { return lhs.sortKey < rhs.sortKey; });
+        for (const auto& pendingCommand : mPendingCommands) {
+            // consecutive destructions are applied as a batch
+            if (pendingCommand.command->type == CommandBuffer::CommandType::DestroyEntity) {
+                mEntitiesToDestroy.push_back(pendingCommand.command->entity);
+                continue;
+            }
+            flushDestructions(registry);
+            pendingCommand.buffer->apply(*pendingCommand.command, registry);
+        }
+        flushDestructions(registry);
+        mPendingCommands.clear();
+        for (const auto& buffer : mBuffers) {
+            buffer->clear();
+        }
+    }
+
+    std::size_t CommandBuffers::numCommands() const noexcept {
+        std::scoped_lock lock{ mMutex };
+        std::size_t result = 0;
+        for (const auto& buffer : mBuffers) {
+            result += buffer->numCommands();
+        }
+        return result;
+    }
+
+    void CommandBuffers::flushDestructions(Registry& registry) noexcept {
+        if (mEntitiesToDestroy.empty()) {
+            return;
+        }
+        // the same entity may have been destroyed multiple times
+        std::sort(mEntitiesToDestroy.begin(), mEntitiesToDestroy.end());
+        mEntitiesToDestroy.erase(std::unique(mEntitiesToDestroy.begin(), mEntitiesToDestroy.end()),
+                                 mEntitiesToDestroy.end());
+        std::erase_if(mEntitiesToDestroy, [&registry](const Entity entity) { return !registry.isEntityAlive(entity); });
+        registry.destroyEntities(mEntitiesToDestroy);
+        mEntitiesToDestroy.clear();
+    }
+
+}// namespace c2k
\ No newline at end of file
@@ -0,0 +1,211 @@
+//
+// Created by coder2k on 06.12.2021.
+//
+
+#pragma once
+
+#include "Entity.hpp"
+#include "Registry.hpp"
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace c2k {
+
+    /* Records structural changes of a registry (creating and destroying entities, attaching and removing
+     * components) so that they can be applied later on at a sync point. The component payloads are copied
+     * into a linear byte arena that keeps its memory between frames. Every command is tagged with the
+     * current sort key, see CommandBuffers::playback(). */
+    class CommandBuffer final {
+    public:
+        CommandBuffer() noexcept = default;
+        CommandBuffer(const CommandBuffer&) = delete;
+        CommandBuffer(CommandBuffer&&) = delete;
+        ~CommandBuffer() noexcept;
+        CommandBuffer& operator=(const CommandBuffer&) = delete;
+        CommandBuffer& operator=(CommandBuffer&&) = delete;
+
+        // applies to all commands that get recorded afterwards
+        void setSortKey(std::uint64_t sortKey) noexcept {
+            mSortKey = sortKey;
+        }
+
+        template<typename... Components>
+        void createEntity(const Components&... components) noexcept {
+            auto records = static_cast<ComponentRecord*>(
+                    allocate(sizeof(ComponentRecord) * sizeof...(Components), alignof(ComponentRecord)));
+            [[maybe_unused]] std::size_t i = 0;
+            ((records[i++] = storeComponent(components)), ...);
+            mCommands.push_back(Command{ .type{ CommandType::CreateEntity },
+                                         .entity{ invalidEntity },
+                                         .sortKey{ mSortKey },
+                                         .components{ records },
+                                         .numComponents{ sizeof...(Components) } });
+        }
+
+        void destroyEntity(Entity entity) noexcept {
+            mCommands.push_back(Command{ .type{ CommandType::DestroyEntity },
+                                         .entity{ entity },
+                                         .sortKey{ mSortKey },
+                                         .components{ nullptr },
+                                         .numComponents{ 0 } });
+        }
+
+        template<typename Component>
+        void attachComponent(Entity entity, const Component& component) noexcept {
+            auto record = static_cast<ComponentRecord*>(allocate(sizeof(ComponentRecord), alignof(ComponentRecord)));
+            *record = storeComponent(component);
+            mCommands.push_back(Command{ .type{ CommandType::AttachComponent },
+                                         .entity{ entity },
+                                         .sortKey{ mSortKey },
+                                         .components{ record },
+                                         .numComponents{ 1 } });
+        }
+
+        template<typename Component>
+        void removeComponent(Entity entity) noexcept {
+            auto record = static_cast<ComponentRecord*>(allocate(sizeof(ComponentRecord), alignof(ComponentRecord)));
+            *record = ComponentRecord{ .operations{ &operationsFor<Component>() }, .component{ nullptr } };
+            mCommands.push_back(Command{ .type{ CommandType::RemoveComponent },
+                                         .entity{ entity },
+                                         .sortKey{ mSortKey },
+                                         .components{ record },
+                                         .numComponents{ 1 } });
+        }
+
+        [[nodiscard]] std::size_t numCommands() const noexcept {
+            return mCommands.size();
+        }
+
+        [[nodiscard]] bool empty() const noexcept {
+            return mCommands.empty();
+        }
+
+        // discards all commands that have not been played back, the memory of the arena is kept
+        void clear() noexcept;
+
+    private:
+        enum class CommandType {
+            CreateEntity,
+            DestroyEntity,
+            AttachComponent,
+            RemoveComponent,
+        };
+
+        struct ComponentOperations {
+            void (*attach)(Registry& registry, Entity entity, const void* component);
+            void (*remove)(Registry& registry, Entity entity);
+            void (*destruct)(void* component);
+        };
+
+        struct ComponentRecord {
+            const ComponentOperations* operations;
+            void* component;
+        };
+
+        struct Command {
+            CommandType type;
+            Entity entity;
+            std::uint64_t sortKey;
+            ComponentRecord* components;// stored inside the arena
+            std::size_t numComponents;
+        };
+
+        static constexpr std::size_t arenaBlockSize = 64 * 1024;
+
+    private:
+        template<typename Component>
+        [[nodiscard]] static const ComponentOperations& operationsFor() noexcept {
+            static constexpr ComponentOperations operations{
+                .attach{ [](Registry& registry, Entity entity, const void* component) {
+                    registry.attachComponent(entity, *static_cast<const Component*>(component));
+                } },
+                .remove{ [](Registry& registry, Entity entity) { registry.removeComponent<Component>(entity); } },
+                .destruct{ [](void* component) { static_cast<Component*>(component)->~Component(); } },
+            };
+            return operations;
+        }
+
+        template<typename Component>
+        [[nodiscard]] ComponentRecord storeComponent(const Component& component) noexcept {
+            static_assert(alignof(Component) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+            auto memory = allocate(sizeof(Component), alignof(Component));
+            return ComponentRecord{ .operations{ &operationsFor<Component>() },
+                                    .component{ new (memory) Component{ component } } };
+        }
+
+        [[nodiscard]] void* allocate(std::size_t size, std::size_t alignment) noexcept;
+        void apply(const Command& command, Registry& registry) const noexcept;
+        void destructPayloads() noexcept;
+
+    private:
+        std::vector<Command> mCommands;
+        std::vector<std::unique_ptr<std::byte[]>> mArenaBlocks;
+        std::size_t mCurrentBlock{ 0 };
+        std::size_t mBlockOffset{ 0 };
+        std::uint64_t mSortKey{ 0 };
+
+        friend class CommandBuffers;
+    };
+
+    /* Hands out one command buffer per thread, so that parallel systems can record commands without any
+     * synchronization. playback() applies the commands of all buffers ordered by their sort keys. Commands
+     * with equal sort keys keep their recording order if they were recorded by the same thread. To get a
+     * deterministic result, parallel systems should use a sort key that identifies the recorded work
+     * independent of the thread (e.g. the entity that is being processed). */
+    class CommandBuffers final {
+    public:
+        CommandBuffers() noexcept;
+        CommandBuffers(const CommandBuffers&) = delete;
+        CommandBuffers(CommandBuffers&&) = delete;
+        ~CommandBuffers() noexcept = default;
+        CommandBuffers& operator=(const CommandBuffers&) = delete;
+        CommandBuffers& operator=(CommandBuffers&&) = delete;
+
+        // buffer that is exclusively used by the calling thread
+        [[nodiscard]] CommandBuffer& local() noexcept;
+
+        // must not be called while other threads are recording, clears all buffers afterwards
+        void playback(Registry& registry) noexcept;
+
+        [[nodiscard]] std::size_t numCommands() const noexcept;
+
+    private:
+        struct ThreadBuffer {
+            std::thread::id threadId;
+            CommandBuffer* buffer;
+        };
+
+        struct LocalBufferCache {
+            std::uint64_t ownerIdentifier;
+            CommandBuffer* buffer;
+        };
+
+        struct PendingCommand {
+            std::uint64_t sortKey;
+            const CommandBuffer* buffer;
+            const CommandBuffer::Command* command;
+        };
+
+    private:
+        void flushDestructions(Registry& registry) noexcept;
+
+    private:
+        const std::uint64_t mIdentifier;
+        mutable std::mutex mMutex;
+        std::vector<std::unique_ptr<CommandBuffer>> mBuffers;
+        std::vector<ThreadBuffer> mThreadBuffers;
+        std::vector<PendingCommand> mPendingCommands;// only used during playback
+        std::vector<Entity> mEntitiesToDestroy;      // only used during playback
+        static inline std::atomic<std::uint64_t> sNextIdentifier{ 1 };
+        static thread_local inline LocalBufferCache sLocalBufferCache{ 0, nullptr };
+    };
+
+}// namespace c2k
\ No newline at end of file
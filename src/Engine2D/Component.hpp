@@ -15,6 +15,9 @@
 #include "ParticleSystem.hpp"
 #include "Sprite.hpp"
 #include "Animation.hpp"
+#include "Snapshot.hpp"
+#include "StructOfArrays.hpp"
+#include "TypeIdentifier.hpp"
 #include "IncludeGLM.hpp"
 
 namespace c2k {
@@ -49,6 +52,12 @@ namespace c2k {
                                        .rotation{ eulerAngles.z },
                                        .scale{ glm::vec2{ scale.x, scale.y } } };
         }
+        [[nodiscard]] bool operator==(const TransformComponent& other) const noexcept = default;
+    };
+
+    // cached global transform of an entity, kept up to date by EntityUtils::updateWorldTransforms()
+    struct WorldTransformComponent {
+        glm::mat4 matrix{ 1.0f };
     };
 
     struct DynamicSpriteComponent {
@@ -112,4 +121,81 @@ namespace c2k {
         glm::vec2 baseScale{ 1.0f };
     };
 
+    // engine components get fixed dense type identifiers in this order
+    using EngineComponentTypes = TypeList<RootComponent,
+                                          RelationshipComponent,
+                                          TransformComponent,
+                                          WorldTransformComponent,
+                                          DynamicSpriteComponent,
+                                          SpriteSheetAnimationComponent,
+                                          CameraComponent,
+                                          ScriptComponent,
+                                          ParticleEmitterComponent,
+                                          ParticleComponent>;
+
+    template<typename Component>
+    requires EngineComponentTypes::contains<Component>
+    struct RegisteredTypeIdentifier<Component> {
+        static constexpr std::size_t value = EngineComponentTypes::indexOf<Component>;
+    };
+
+    // asset pointers that are stored as GUIDs within registry snapshots
+    template<>
+    struct AssetReferences<DynamicSpriteComponent> {
+        static void forEach(DynamicSpriteComponent& component, auto&& function) noexcept {
+            function(component.shaderProgram);
+            function(component.sprite.texture);
+        }
+    };
+
+    template<>
+    struct AssetReferences<ScriptComponent> {
+        static void forEach(ScriptComponent& component, auto&& function) noexcept {
+            function(component.script);
+        }
+    };
+
+    template<>
+    struct AssetReferences<ParticleEmitterComponent> {
+        static void forEach(ParticleEmitterComponent& component, auto&& function) noexcept {
+            function(component.particleSystem);
+        }
+    };
+
+    template<>
+    struct AssetReferences<ParticleComponent> {
+        static void forEach(ParticleComponent& component, auto&& function) noexcept {
+            function(component.particleSystem);
+        }
+    };
+
+    // sprite sheets and animations don't have GUIDs, so they can only be restored within the same process
+    template<>
+    struct HasProcessLocalPointers<SpriteSheetAnimationComponent> : std::true_type { };
+
+    // the particle update only touches a few members per pass, so particles are stored as structure of arrays
+    template<>
+    struct StructOfArrays<ParticleComponent> {
+        static constexpr std::tuple members{ &ParticleComponent::particleSystem,
+                                             &ParticleComponent::remainingLifeTime,
+                                             &ParticleComponent::totalLifeTime,
+                                             &ParticleComponent::particleEmitterEntity,
+                                             &ParticleComponent::velocityFromGravity,
+                                             &ParticleComponent::startVelocity,
+                                             &ParticleComponent::gravity,
+                                             &ParticleComponent::baseScale };
+
+        template<bool isConst>
+        struct Reference {
+            ColumnReference<const ParticleSystem*, isConst> particleSystem;
+            ColumnReference<double, isConst> remainingLifeTime;
+            ColumnReference<double, isConst> totalLifeTime;
+            ColumnReference<Entity, isConst> particleEmitterEntity;
+            ColumnReference<glm::vec3, isConst> velocityFromGravity;
+            ColumnReference<glm::vec3, isConst> startVelocity;
+            ColumnReference<glm::vec3, isConst> gravity;
+            ColumnReference<glm::vec2, isConst> baseScale;
+        };
+    };
+
 }// namespace c2k
\ No newline at end of file
@@ -8,7 +8,13 @@
 #include "SparseSet.hpp"
 #include "TypeIdentifier.hpp"
 #include "ComponentHolderPairIterator.hpp"
+#include "JobSystem.hpp"
 #include <gsl/gsl>
+#include <algorithm>
+#include <array>
+#include <span>
+#include <utility>
+#include <vector>
 
 namespace c2k {
 
@@ -29,10 +35,66 @@ namespace c2k {
         template<typename Component>
         void attach(SparseIndex entity, const Component& component) noexcept {
             getComponentMutable<Component>().add(entity, std::move(component));
+            const auto groupIndex = owningGroupIndex(TypeIdentifier::template get<Component>());
+            if (groupIndex != noOwningGroup) {
+                enterGroupIfComplete(mOwningGroups[groupIndex], entity);
+            }
+        }
+        // attaches a copy of component to all given entities, appending to the storage in bulk
+        template<typename Component>
+        void attachMany(std::span<const SparseSet::Index> entities, const Component& component) noexcept {
+            getComponentMutable<Component>().addMany(entities, component);
+            const auto groupIndex = owningGroupIndex(TypeIdentifier::template get<Component>());
+            if (groupIndex != noOwningGroup) {
+                for (const auto entity : entities) {
+                    enterGroupIfComplete(mOwningGroups[groupIndex], entity);
+                }
+            }
         }
         template<typename Component>
         void remove(SparseIndex entity) noexcept {
-            getComponentMutable<Component>().remove(entity);
+            removeTypeErased(TypeIdentifier::template get<Component>(), entity);
+        }
+        void removeTypeErased(typename TypeIdentifier::UnderlyingType typeIdentifier, SparseIndex entity) noexcept {
+            assert(typeIdentifier < mSparseSets.size() && mSparseSets[typeIdentifier] != nullptr);
+            const auto groupIndex = owningGroupIndex(typeIdentifier);
+            if (groupIndex != noOwningGroup) {
+                leaveGroupIfMember(mOwningGroups[groupIndex], entity);
+            }
+            mSparseSets[typeIdentifier]->remove(entity);
+        }
+        // removes the components of all given entities (which must have one) with a single visit of the storage
+        void removeTypeErased(typename TypeIdentifier::UnderlyingType typeIdentifier,
+                              std::span<const SparseSet::Index> entities) noexcept {
+            assert(typeIdentifier < mSparseSets.size() && mSparseSets[typeIdentifier] != nullptr);
+            const auto groupIndex = owningGroupIndex(typeIdentifier);
+            if (groupIndex != noOwningGroup) {
+                for (const auto entity : entities) {
+                    leaveGroupIfMember(mOwningGroups[groupIndex], entity);
+                }
+            }
+            mSparseSets[typeIdentifier]->removeMany(entities);
+        }
+        void removeAll(SparseIndex entity) noexcept {
+            removeAll(std::span{ &entity, 1 });
+        }
+        // removes all components of all given entities, visiting each sparse set only once
+        void removeAll(std::span<const SparseIndex> entities) noexcept {
+            for (std::size_t typeIdentifier = 0; typeIdentifier < mSparseSets.size(); ++typeIdentifier) {
+                if (mSparseSets[typeIdentifier] == nullptr || mSparseSets[typeIdentifier]->elementCount() == 0) {
+                    continue;
+                }
+                for (const auto entity : entities) {
+                    if (mSparseSets[typeIdentifier]->has(entity)) {
+                        removeTypeErased(typeIdentifier, entity);
+                    }
+                }
+            }
+        }
+        template<typename Component>
+        void reserve(std::size_t additionalElements) noexcept {
+            auto& sparseSet = getComponentMutable<Component>();
+            sparseSet.reserve(sparseSet.elementCount() + additionalElements);
         }
         void resize(std::size_t size) noexcept {
             using ranges::views::zip;
@@ -80,65 +142,11 @@ namespace c2k {
         }
 
         [[nodiscard]] auto getTypeErasedMutable(auto typeIdentifiersBegin, auto typeIdentifiersEnd) const noexcept {
-            using SetIterator = decltype(mSparseSets.front()->indicesBegin());
-            const auto predicate = [=, this](Entity entity) {
-                for (auto it = typeIdentifiersBegin; it != typeIdentifiersEnd; ++it) {
-                    if (!(mSparseSets[*it]->has(entity))) {
-                        return false;
-                    }
-                }
-                return true;
-            };
-            const auto numTypes{ gsl::narrow_cast<std::size_t>(
-                    std::distance(typeIdentifiersBegin, typeIdentifiersEnd)) };
-            const auto getPointersFunc = [=, this](Entity entity) {
-                std::vector<void*> pointers;
-                pointers.reserve(numTypes);
-                for (auto it = typeIdentifiersBegin; it != typeIdentifiersEnd; ++it) {
-                    pointers.push_back(mSparseSets[*it]->getTypeErasedMutable(entity));
-                }
-                return pointers;
-            };
-            using PairIterator =
-                    ComponentHolderPairIterator<SetIterator, decltype(predicate), decltype(getPointersFunc)>;
-            const auto indicesBegin{ mSparseSets[*typeIdentifiersBegin]->indicesBegin() };
-            const auto indicesEnd{ mSparseSets[*typeIdentifiersBegin]->indicesEnd() };
-            const auto indicesCount{ gsl::narrow_cast<std::size_t>(std::distance(indicesBegin, indicesEnd)) };
-            auto beginIterator = PairIterator{ indicesBegin, indicesEnd, predicate, getPointersFunc };
-            auto endIterator = PairIterator{ indicesBegin, indicesEnd, predicate, getPointersFunc, indicesCount };
-
-            return std::make_pair(beginIterator, endIterator);
+            return getTypeErasedIterators<ComponentHolderPairIterator>(typeIdentifiersBegin, typeIdentifiersEnd);
         }
 
         [[nodiscard]] auto getTypeErased(auto typeIdentifiersBegin, auto typeIdentifiersEnd) const noexcept {
-            using SetIterator = decltype(mSparseSets.front()->indicesBegin());
-            const auto predicate = [=, this](Entity entity) {
-                for (auto it = typeIdentifiersBegin; it != typeIdentifiersEnd; ++it) {
-                    if (!(mSparseSets[*it]->has(entity))) {
-                        return false;
-                    }
-                }
-                return true;
-            };
-            const auto numTypes{ gsl::narrow_cast<std::size_t>(
-                    std::distance(typeIdentifiersBegin, typeIdentifiersEnd)) };
-            const auto getPointersFunc = [=, this](Entity entity) {
-                std::vector<const void*> pointers;
-                pointers.reserve(numTypes);
-                for (auto it = typeIdentifiersBegin; it != typeIdentifiersEnd; ++it) {
-                    pointers.push_back(mSparseSets[*it]->getTypeErased(entity));
-                }
-                return pointers;
-            };
-            using PairIterator =
-                    ConstComponentHolderPairIterator<SetIterator, decltype(predicate), decltype(getPointersFunc)>;
-            const auto indicesBegin{ mSparseSets[*typeIdentifiersBegin]->indicesBegin() };
-            const auto indicesEnd{ mSparseSets[*typeIdentifiersBegin]->indicesEnd() };
-            const auto indicesCount{ gsl::narrow_cast<std::size_t>(std::distance(indicesBegin, indicesEnd)) };
-            auto beginIterator = PairIterator{ indicesBegin, indicesEnd, predicate, getPointersFunc };
-            auto endIterator = PairIterator{ indicesBegin, indicesEnd, predicate, getPointersFunc, indicesCount };
-
-            return std::make_pair(beginIterator, endIterator);
+            return getTypeErasedIterators<ConstComponentHolderPairIterator>(typeIdentifiersBegin, typeIdentifiersEnd);
         }
 
         template<typename FirstComponent, typename... Components>
@@ -150,10 +158,13 @@ namespace c2k {
                    filter([this]([[maybe_unused]] auto&& tuple) {
                        return (has<Components>(std::get<0>(tuple)) && ...);
                    }) |
+                   // proxies of structure of arrays storages are held by value
                    transform([this](auto&& tuple) {
-                       return std::forward_as_tuple(std::get<0>(tuple), std::get<1>(tuple),
-                                                    getComponentMutable<Components>().template getMutable<Components>(
-                                                            std::get<0>(tuple))...);
+                       return std::tuple<const SparseIndex&, ComponentReference<FirstComponent>,
+                                         ComponentReference<Components>...>(
+                               std::get<0>(tuple), std::get<1>(tuple),
+                               getComponentMutable<Components>().template getMutable<Components>(
+                                       std::get<0>(tuple))...);
                    });
         }
 
@@ -167,20 +178,205 @@ namespace c2k {
                        return (has<Components>(std::get<0>(tuple)) && ...);
                    }) |
                    transform([this](auto&& tuple) {
-                       return std::forward_as_tuple(
+                       return std::tuple<const SparseIndex&, ComponentReference<const FirstComponent>,
+                                         ComponentReference<const Components>...>(
                                std::get<0>(tuple), std::get<1>(tuple),
                                getComponent<Components>().template get<Components>(std::get<0>(tuple))...);
                    });
         }
+
+        /* Calls function(entity, components...) for every entity that has all the given components. The dense
+         * array of the smallest participating set is split into chunks of grainSize entities which are scheduled
+         * as jobs on jobSystem (if any). The calling thread processes a chunk itself and helps with the others
+         * until all are done. See Registry::parallelEach() for the rules on what function may modify. */
+        template<typename... Components>
+        void parallelEachMutable(auto&& function, std::size_t grainSize, JobSystem* jobSystem) noexcept {
+            assert(grainSize > 0);
+            const std::array<SparseSet*, sizeof...(Components)> sparseSets{ &getComponentMutable<Components>()... };
+            const SparseSet& driver = **std::min_element(sparseSets.begin(), sparseSets.end(), [](auto lhs, auto rhs) {
+                return lhs->elementCount() < rhs->elementCount();
+            });
+            const auto numElements = driver.elementCount();
+            const auto processChunk = [&]<std::size_t... indices>(std::size_t chunk, std::index_sequence<indices...>) {
+                const auto first = driver.indicesBegin() + static_cast<std::ptrdiff_t>(chunk * grainSize);
+                const auto last = driver.indicesBegin() +
+                                  static_cast<std::ptrdiff_t>(std::min((chunk + 1) * grainSize, numElements));
+                for (auto it = first; it != last; ++it) {
+                    const auto entity = static_cast<SparseIndex>(*it);
+                    if ((sparseSets[indices]->has(entity) && ...)) {
+                        function(entity, sparseSets[indices]->template getMutable<Components>(entity)...);
+                    }
+                }
+            };
+            const auto numChunks = (numElements + grainSize - 1) / grainSize;
+            if (numChunks <= 1 || jobSystem == nullptr) {
+                for (std::size_t chunk = 0; chunk < numChunks; ++chunk) {
+                    processChunk(chunk, std::index_sequence_for<Components...>{});
+                }
+                return;
+            }
+            JobCounter counter{ 0 };
+            for (std::size_t chunk = 1; chunk < numChunks; ++chunk) {
+                jobSystem->schedule(
+                        [&processChunk, chunk] { processChunk(chunk, std::index_sequence_for<Components...>{}); },
+                        counter);
+            }
+            processChunk(0, std::index_sequence_for<Components...>{});
+            jobSystem->wait(counter);
+        }
+
+        /* Calls function(entity, components&...) for every entity that has all the given components. This is a
+         * plain loop: the storages are looked up once before iterating and an owning group that consists of
+         * exactly the given components is walked via its packed dense arrays without any sparse lookups. */
+        template<typename... Components>
+        void eachMutable(auto&& function) noexcept {
+            if (!(doesExist<Components>() && ...)) {
+                return;
+            }
+            const std::array<SparseSet*, sizeof...(Components)> sparseSets{ &getComponentMutable<Components>()... };
+            const auto loop = [&]<std::size_t... indices>(std::index_sequence<indices...>) {
+                if (const auto size = exactGroupSize<Components...>(); size > 0) {
+                    const auto entities = sparseSets.front()->indicesBegin();
+                    const std::tuple elements{ sparseSets[indices]->template elementsMutable<Components>().begin()... };
+                    for (std::size_t i = 0; i < size; ++i) {
+                        const auto offset = static_cast<std::ptrdiff_t>(i);
+                        function(static_cast<SparseIndex>(entities[offset]), std::get<indices>(elements)[offset]...);
+                    }
+                    return;
+                }
+                const SparseSet& driver = **std::min_element(sparseSets.begin(), sparseSets.end(), [](auto l, auto r) {
+                    return l->elementCount() < r->elementCount();
+                });
+                const auto last = driver.indicesEnd();
+                for (auto it = driver.indicesBegin(); it != last; ++it) {
+                    const auto entity = static_cast<SparseIndex>(*it);
+                    if ((sparseSets[indices]->has(entity) && ...)) {
+                        function(entity, sparseSets[indices]->template getMutable<Components>(entity)...);
+                    }
+                }
+            };
+            loop(std::index_sequence_for<Components...>{});
+        }
+
+        /* Registers an owning group: all entities that have every one of the given components are
+         * kept packed at the front of each participating sparse set (in the same order), so that
+         * iterating over the group is a linear walk over contiguous arrays. A component type can
+         * only be owned by a single group. */
+        template<typename... Components>
+        requires(sizeof...(Components) >= 2) void registerGroup() noexcept {
+            (growIfNecessaryAndGetTypeIdentifier<Components>(), ...);
+            OwningGroup group{ .typeIdentifiers{ TypeIdentifier::template get<Components>()... } };
+            for (const auto typeIdentifier : group.typeIdentifiers) {
+                if (typeIdentifier >= mOwningGroupIndices.size()) {
+                    mOwningGroupIndices.resize(typeIdentifier + 1, noOwningGroup);
+                }
+                assert(mOwningGroupIndices[typeIdentifier] == noOwningGroup &&
+                       "A component type can only be owned by one group.");
+                mOwningGroupIndices[typeIdentifier] = mOwningGroups.size();
+            }
+            // the dense vector gets reordered while entering the group, so we need a copy
+            const auto& firstSet = *mSparseSets[group.typeIdentifiers.front()];
+            const std::vector<SparseIndex> candidates(firstSet.indicesBegin(), firstSet.indicesEnd());
+            for (const auto entity : candidates) {
+                enterGroupIfComplete(group, entity);
+            }
+            mOwningGroups.push_back(std::move(group));
+        }
+
+        /* Sorts the storage of the given component in place. If the component is owned by a group, the
+         * group members stay packed at the front and all sets of the group are permuted alike. */
+        template<typename Component, typename Compare>
+        void sort(Compare compare, SortAlgorithm algorithm) noexcept {
+            auto& sparseSet = getComponentMutable<Component>();
+            const auto groupIndex = owningGroupIndex(TypeIdentifier::template get<Component>());
+            std::size_t groupSize{ 0 };
+            if (groupIndex != noOwningGroup) {
+                const auto& group = mOwningGroups[groupIndex];
+                groupSize = group.size;
+                const auto order = sparseSet.template sortedOrder<Component>(0, groupSize, compare, algorithm);
+                for (const auto typeIdentifier : group.typeIdentifiers) {
+                    mSparseSets[typeIdentifier]->permute(0, order);
+                }
+            }
+            const auto order =
+                    sparseSet.template sortedOrder<Component>(groupSize, sparseSet.elementCount(), compare, algorithm);
+            sparseSet.permute(groupSize, order);
+        }
+
+        // moves all Follower components whose entities also have a Leader to the front, in the order of the Leaders
+        template<typename Follower, typename Leader>
+        void followOrder() noexcept {
+            assert(owningGroupIndex(TypeIdentifier::template get<Follower>()) == noOwningGroup &&
+                   "The order of components that are owned by a group can't be changed.");
+            auto& follower = getComponentMutable<Follower>();
+            const auto& leader = getComponentMutable<Leader>();
+            std::size_t position{ 0 };
+            for (auto it = leader.indicesBegin(); it != leader.indicesEnd(); ++it) {
+                if (follower.has(*it)) {
+                    follower.swapDenseEntries(follower.denseIndex(*it), position);
+                    ++position;
+                }
+            }
+        }
+
+        template<typename... Components>
+        [[nodiscard]] std::size_t groupSize() const noexcept {
+            return findOwningGroup<Components...>().size;
+        }
+
+        template<typename FirstComponent, typename... Components>
+        [[nodiscard]] auto groupMutable() noexcept {
+            using ranges::subrange, ranges::views::zip;
+            const auto size = static_cast<std::ptrdiff_t>(findOwningGroup<FirstComponent, Components...>().size);
+            auto& firstSet = getComponentMutable<FirstComponent>();
+            return zip(subrange(firstSet.indicesBegin(), firstSet.indicesBegin() + size),
+                       subrange(firstSet.template elementsMutable<FirstComponent>().begin(),
+                                firstSet.template elementsMutable<FirstComponent>().begin() + size),
+                       subrange(getComponentMutable<Components>().template elementsMutable<Components>().begin(),
+                                getComponentMutable<Components>().template elementsMutable<Components>().begin() +
+                                        size)...);
+        }
+
+        template<typename FirstComponent, typename... Components>
+        [[nodiscard]] auto group() const noexcept {
+            using ranges::subrange, ranges::views::zip;
+            const auto size = static_cast<std::ptrdiff_t>(findOwningGroup<FirstComponent, Components...>().size);
+            const auto& firstSet = getComponent<FirstComponent>();
+            return zip(subrange(firstSet.indicesBegin(), firstSet.indicesBegin() + size),
+                       subrange(firstSet.template elements<FirstComponent>().begin(),
+                                firstSet.template elements<FirstComponent>().begin() + size),
+                       subrange(getComponent<Components>().template elements<Components>().begin(),
+                                getComponent<Components>().template elements<Components>().begin() + size)...);
+        }
+
         template<typename Component>
-        [[nodiscard]] Component& getMutable(SparseIndex entity) noexcept {
+        [[nodiscard]] ComponentReference<Component> getMutable(SparseIndex entity) noexcept {
             return getComponentMutable<Component>().template getMutable<Component>(entity);
         }
 
         template<typename Component>
-        [[nodiscard]] const Component& get(SparseIndex entity) const noexcept {
+        [[nodiscard]] ComponentReference<const Component> get(SparseIndex entity) const noexcept {
             return getComponent<Component>().template get<Component>(entity);
         }
+
+        // empty if no component of the type has been attached yet
+        template<auto member>
+        [[nodiscard]] auto columnMutable() noexcept {
+            using Traits = StructOfArraysImpl::MemberPointerTraits<decltype(member)>;
+            if (!doesExist<typename Traits::ClassType>()) {
+                return std::span<typename Traits::MemberType>{};
+            }
+            return getComponentMutable<typename Traits::ClassType>().template columnMutable<member>();
+        }
+
+        template<auto member>
+        [[nodiscard]] auto column() const noexcept {
+            using Traits = StructOfArraysImpl::MemberPointerTraits<decltype(member)>;
+            if (!doesExist<typename Traits::ClassType>()) {
+                return std::span<const typename Traits::MemberType>{};
+            }
+            return getComponent<typename Traits::ClassType>().template column<member>();
+        }
         template<typename Component>
         [[nodiscard]] std::size_t typeIdentifier() const noexcept {
             return TypeIdentifier::template get<Component>();
@@ -195,7 +391,186 @@ namespace c2k {
             growIfNecessaryAndGetTypeIdentifier<T>();
         }
 
+        void writeSnapshot(SnapshotWriter& writer) const noexcept {
+            const auto numSparseSets = std::count_if(mSparseSets.begin(), mSparseSets.end(),
+                                                     [](const auto pointerToSet) { return pointerToSet != nullptr; });
+            writer.write(static_cast<std::uint64_t>(numSparseSets));
+            for (const auto pointerToSet : mSparseSets) {
+                if (pointerToSet != nullptr) {
+                    writer.write(pointerToSet->typeHash());
+                    pointerToSet->writeSnapshot(writer);
+                }
+            }
+            writer.write(static_cast<std::uint64_t>(mOwningGroups.size()));
+            for (const auto& group : mOwningGroups) {
+                writer.write(static_cast<std::uint64_t>(group.size));
+            }
+        }
+
+        /* Skips the data that readSnapshot() would read and checks whether all component types and groups
+         * of the snapshot are registered and all sparse indices are marked in validIndices. The elements of each
+         * storage are passed to validateElements(typeIdentifier, elements, count), which returns false to reject
+         * them (see SparseSet::validateSnapshot()). */
+        [[nodiscard]] bool validateSnapshot(SnapshotReader& reader,
+                                            const std::vector<bool>& validIndices,
+                                            const auto& validateElements) const noexcept {
+            std::uint64_t numSparseSets;
+            if (!reader.tryRead(numSparseSets)) {
+                spdlog::error("Snapshot is truncated.");
+                return false;
+            }
+            std::vector<std::size_t> counts(mSparseSets.size(), 0);// indexed by type identifier
+            std::vector<bool> restored(mSparseSets.size(), false);
+            for (std::uint64_t i = 0; i < numSparseSets; ++i) {
+                std::uint64_t typeHash;
+                if (!reader.tryRead(typeHash)) {
+                    spdlog::error("Snapshot is truncated.");
+                    return false;
+                }
+                const auto typeIdentifier = findTypeIdentifier(typeHash);
+                if (typeIdentifier == mSparseSets.size() || restored[typeIdentifier]) {
+                    spdlog::error("Snapshot contains an unknown or duplicate component type (hash {}).", typeHash);
+                    return false;
+                }
+                const std::byte* elements;
+                if (!mSparseSets[typeIdentifier]->validateSnapshot(reader, validIndices, counts[typeIdentifier],
+                                                                   elements) ||
+                    !validateElements(typeIdentifier, elements, counts[typeIdentifier])) {
+                    return false;
+                }
+                restored[typeIdentifier] = true;
+            }
+            std::uint64_t numGroups;
+            if (!reader.tryRead(numGroups) || numGroups != mOwningGroups.size()) {
+                spdlog::error("Owning groups of the snapshot don't match.");
+                return false;
+            }
+            for (const auto& group : mOwningGroups) {
+                std::uint64_t groupSize;
+                if (!reader.tryRead(groupSize)) {
+                    spdlog::error("Snapshot is truncated.");
+                    return false;
+                }
+                for (const auto typeIdentifier : group.typeIdentifiers) {
+                    if (groupSize > counts[typeIdentifier]) {
+                        spdlog::error("Owning group of the snapshot is larger than its storages.");
+                        return false;
+                    }
+                }
+            }
+            return true;
+        }
+
+        /* All component types and groups of the snapshot have to be registered already. The storages are
+         * matched by type hash, so the type identifiers may differ from the ones of the snapshot. The snapshot
+         * has to be validated before (see validateSnapshot()). */
+        void readSnapshot(SnapshotReader& reader) noexcept {
+            std::vector<bool> restored(mSparseSets.size(), false);
+            const auto numSparseSets = reader.read<std::uint64_t>();
+            for (std::uint64_t i = 0; i < numSparseSets; ++i) {
+                const auto typeIdentifier = findTypeIdentifier(reader.read<std::uint64_t>());
+                assert(typeIdentifier < mSparseSets.size() && "Unknown component type within snapshot.");
+                mSparseSets[typeIdentifier]->readSnapshot(reader);
+                restored[typeIdentifier] = true;
+            }
+            for (std::size_t typeIdentifier = 0; typeIdentifier < mSparseSets.size(); ++typeIdentifier) {
+                if (mSparseSets[typeIdentifier] != nullptr && !restored[typeIdentifier]) {
+                    mSparseSets[typeIdentifier]->clear();
+                }
+            }
+            [[maybe_unused]] const auto numGroups = reader.read<std::uint64_t>();
+            assert(numGroups == mOwningGroups.size() && "Owning groups of the snapshot don't match.");
+            for (auto& group : mOwningGroups) {
+                group.size = static_cast<std::size_t>(reader.read<std::uint64_t>());
+            }
+        }
+
     private:
+        struct OwningGroup {
+            std::vector<typename TypeIdentifier::UnderlyingType> typeIdentifiers;
+            std::size_t size{ 0 };
+        };
+
+        static constexpr std::size_t noOwningGroup = std::numeric_limits<std::size_t>::max();
+
+        // mSparseSets.size() if no storage of the given type hash is registered
+        [[nodiscard]] std::size_t findTypeIdentifier(std::uint64_t typeHash) const noexcept {
+            const auto it = std::find_if(mSparseSets.begin(), mSparseSets.end(), [typeHash](const auto pointerToSet) {
+                return pointerToSet != nullptr && pointerToSet->typeHash() == typeHash;
+            });
+            return static_cast<std::size_t>(std::distance(mSparseSets.begin(), it));
+        }
+
+        [[nodiscard]] std::size_t owningGroupIndex(
+                typename TypeIdentifier::UnderlyingType typeIdentifier) const noexcept {
+            return typeIdentifier < mOwningGroupIndices.size() ? mOwningGroupIndices[typeIdentifier] : noOwningGroup;
+        }
+
+        // size of the owning group that consists of exactly the given components (0 if there is none)
+        template<typename FirstComponent, typename... Components>
+        [[nodiscard]] std::size_t exactGroupSize() const noexcept {
+            const auto groupIndex = owningGroupIndex(TypeIdentifier::template get<FirstComponent>());
+            if (groupIndex == noOwningGroup ||
+                mOwningGroups[groupIndex].typeIdentifiers.size() != 1 + sizeof...(Components) ||
+                !((owningGroupIndex(TypeIdentifier::template get<Components>()) == groupIndex) && ...)) {
+                return 0;
+            }
+            return mOwningGroups[groupIndex].size;
+        }
+
+        template<typename PairIterator>
+        [[nodiscard]] auto getTypeErasedIterators(auto typeIdentifiersBegin, auto typeIdentifiersEnd) const noexcept {
+            typename PairIterator::SparseSets sparseSets{};
+            std::size_t numSparseSets{ 0 };
+            for (auto it = typeIdentifiersBegin; it != typeIdentifiersEnd; ++it) {
+                assert(numSparseSets < sparseSets.size() && "Too many component types for a type erased query.");
+                sparseSets[numSparseSets] = (*it < mSparseSets.size() ? mSparseSets[*it] : nullptr);
+                ++numSparseSets;
+            }
+            return std::make_pair(PairIterator{ sparseSets, numSparseSets },
+                                  PairIterator{ sparseSets, numSparseSets, true });
+        }
+
+        template<typename FirstComponent, typename... Components>
+        [[nodiscard]] const OwningGroup& findOwningGroup() const noexcept {
+            const auto groupIndex = owningGroupIndex(TypeIdentifier::template get<FirstComponent>());
+            assert(groupIndex != noOwningGroup && "The group has not been registered.");
+            const auto& group = mOwningGroups[groupIndex];
+            assert(group.typeIdentifiers.size() == 1 + sizeof...(Components) &&
+                   ((owningGroupIndex(TypeIdentifier::template get<Components>()) == groupIndex) && ...) &&
+                   "The requested components do not match the registered group.");
+            return group;
+        }
+
+        void enterGroupIfComplete(OwningGroup& group, SparseIndex entity) noexcept {
+            for (const auto typeIdentifier : group.typeIdentifiers) {
+                const auto sparseSet = mSparseSets[typeIdentifier];
+                if (sparseSet == nullptr || !sparseSet->has(entity)) {
+                    return;
+                }
+            }
+            if (mSparseSets[group.typeIdentifiers.front()]->denseIndex(entity) < group.size) {
+                return;// already a member
+            }
+            for (const auto typeIdentifier : group.typeIdentifiers) {
+                auto& sparseSet = *mSparseSets[typeIdentifier];
+                sparseSet.swapDenseEntries(sparseSet.denseIndex(entity), group.size);
+            }
+            ++group.size;
+        }
+
+        void leaveGroupIfMember(OwningGroup& group, SparseIndex entity) noexcept {
+            const auto& firstSet = *mSparseSets[group.typeIdentifiers.front()];
+            if (!firstSet.has(entity) || firstSet.denseIndex(entity) >= group.size) {
+                return;
+            }
+            --group.size;
+            for (const auto typeIdentifier : group.typeIdentifiers) {
+                auto& sparseSet = *mSparseSets[typeIdentifier];
+                sparseSet.swapDenseEntries(sparseSet.denseIndex(entity), group.size);
+            }
+        }
+
         template<typename Component>
         [[nodiscard]] SparseSet& getComponentMutable() noexcept {
             const auto typeIdentifier = growIfNecessaryAndGetTypeIdentifier<Component>();
@@ -220,8 +595,7 @@ namespace c2k {
             if (needsResizing) {
                 mSparseSets.resize(typeIdentifier + 1, nullptr);
             }
-            mSparseSets[typeIdentifier] =
-                    new SparseSet{ std::type_identity<Component>{}, static_cast<SparseIndex>(mSetSize) };
+            mSparseSets[typeIdentifier] = new SparseSet{ std::type_identity<Component>{}, mSetSize };
             return typeIdentifier;
         }
 
@@ -234,6 +608,8 @@ namespace c2k {
     private:
         std::vector<SparseSet*> mSparseSets;
         std::size_t mSetSize;
+        std::vector<OwningGroup> mOwningGroups;
+        std::vector<std::size_t> mOwningGroupIndices;// indexed by type identifier
     };
 
 }// namespace c2k
\ No newline at end of file
@@ -4,15 +4,37 @@
 
 #pragma once
 
+#include "Entity.hpp"
+#include "SparseSet.hpp"
+#include <gsl/gsl>
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
 namespace c2k {
 
-    template<typename Iterator, typename Predicate, typename GetPointersFunc>
-    class ConstComponentHolderPairIterator final {
+    // upper limit for the number of component types within a single type erased query
+    inline constexpr std::size_t maxTypeErasedQueryComponents = 16;
+
+    /* Iterates over all entities that have every component of a runtime list of sparse sets.
+     * The smallest set drives the iteration, all other sets are only probed. Dereferencing
+     * yields the component pointers in the order of the given sets without any heap allocation. */
+    template<bool isConst>
+    class BasicComponentHolderPairIterator final {
     public:
-        class ConstPair final {
+        using SparseSetPointer = std::conditional_t<isConst, const SparseSet*, SparseSet*>;
+        using ElementPointer = std::conditional_t<isConst, const void*, void*>;
+        using SparseSets = std::array<SparseSetPointer, maxTypeErasedQueryComponents>;
+
+        class Pair final {
         public:
-            [[nodiscard]] const void* get(std::size_t index) const noexcept {
-                assert(index < mPointers.size());
+            [[nodiscard]] ElementPointer get(std::size_t index) const noexcept {
+                assert(index < mNumPointers);
                 return mPointers[index];
             }
 
@@ -21,165 +43,111 @@ namespace c2k {
             }
 
         private:
-            std::size_t mIndex;
-            std::vector<const void*> mPointers;
+            std::size_t mIndex{ 0 };
+            std::size_t mNumPointers{ 0 };
+            std::array<ElementPointer, maxTypeErasedQueryComponents> mPointers{};
 
-            friend class ConstComponentHolderPairIterator;
+            friend class BasicComponentHolderPairIterator;
         };
 
     public:
         using iterator_category = std::forward_iterator_tag;
         using difference_type = std::ptrdiff_t;
-        using value_type = ConstPair;
-        using pointer = ConstPair;
-        using reference = ConstPair;
+        using value_type = Pair;
+        using pointer = Pair;
+        using reference = Pair;
+
+    private:
+        using IndexIterator = std::vector<SparseSet::Index>::const_iterator;
 
     public:
-        ConstComponentHolderPairIterator(Iterator begin,
-                                         Iterator end,
-                                         Predicate predicate,
-                                         GetPointersFunc getPointersFunc,
-                                         std::size_t offset = 0)
-            : mCurrent{ begin + offset },
-              mBegin{ begin },
-              mEnd{ end },
-              mPredicate{ predicate },
-              mGetPointersFunc{ getPointersFunc } { }
-
-        [[nodiscard]] bool operator==(const ConstComponentHolderPairIterator& other) const noexcept {
-            return mBegin == other.mBegin && mEnd == other.mEnd && mCurrent == other.mCurrent;
+        BasicComponentHolderPairIterator(const SparseSets& sparseSets, std::size_t numSparseSets, bool isEnd = false)
+            : mSparseSets{ sparseSets },
+              mNumSparseSets{ numSparseSets } {
+            assert(numSparseSets > 0 && numSparseSets <= maxTypeErasedQueryComponents);
+            const auto setsBegin = mSparseSets.begin();
+            const auto setsEnd = mSparseSets.begin() + static_cast<std::ptrdiff_t>(mNumSparseSets);
+            if (std::find(setsBegin, setsEnd, nullptr) != setsEnd) {
+                return;// at least one component type has never been used => nothing to iterate
+            }
+            mDriver = gsl::narrow_cast<std::size_t>(std::distance(
+                    setsBegin, std::min_element(setsBegin, setsEnd, [](const auto lhs, const auto rhs) {
+                        return lhs->elementCount() < rhs->elementCount();
+                    })));
+            const SparseSet& driver = *mSparseSets[mDriver];
+            mCurrent = isEnd ? driver.indicesEnd() : driver.indicesBegin();
+            mEnd = driver.indicesEnd();
+            skipNonMatching();
         }
 
-        [[nodiscard]] bool operator!=(const ConstComponentHolderPairIterator& other) const noexcept {
+        [[nodiscard]] bool operator==(const BasicComponentHolderPairIterator& other) const noexcept {
+            return mCurrent == other.mCurrent;
+        }
+
+        [[nodiscard]] bool operator!=(const BasicComponentHolderPairIterator& other) const noexcept {
             return !((*this) == other);
         }
 
         [[nodiscard]] value_type operator*() const noexcept {
-            using ranges::views::transform, ranges::to_vector;
-            ConstPair result;
-            result.mIndex = (mIndexTransformer == nullptr ? *mCurrent : mIndexTransformer(*mCurrent));
-            result.mPointers = mGetPointersFunc(*mCurrent);
+            assert(mCurrent != mEnd && "no more elements");
+            Pair result;
+            result.mIndex = (mEntityHandles == nullptr ? *mCurrent : mEntityHandles[*mCurrent]);
+            result.mNumPointers = mNumSparseSets;
+            for (std::size_t i = 0; i < mNumSparseSets; ++i) {
+                if constexpr (isConst) {
+                    result.mPointers[i] = mSparseSets[i]->getTypeErased(*mCurrent);
+                } else {
+                    result.mPointers[i] = mSparseSets[i]->getTypeErasedMutable(*mCurrent);
+                }
+            }
             return result;
         }
 
-        [[nodiscard]] pointer operator->() const noexcept { }
-
-        ConstComponentHolderPairIterator operator++(int) noexcept {// postfix
+        BasicComponentHolderPairIterator operator++(int) noexcept {// postfix
             const auto copy{ *this };
             ++(*this);
             return copy;
         }
 
-        ConstComponentHolderPairIterator& operator++() noexcept {// prefix
-            assert(mBegin != mEnd && "no more elements");
-            while (true) {
-                ++mCurrent;
-                if (mCurrent == mEnd || mPredicate(*mCurrent)) {
-                    break;
-                }
-            }
+        BasicComponentHolderPairIterator& operator++() noexcept {// prefix
+            assert(mCurrent != mEnd && "no more elements");
+            ++mCurrent;
+            skipNonMatching();
             return *this;
         }
 
-        void setIndexTransformerFunc(std::function<std::size_t(std::size_t)> func) noexcept {
-            mIndexTransformer = std::move(func);
+        /* Pair::index() yields entityHandles[sparseIndex] instead of the sparse index itself. The table
+         * must not be reallocated while iterating. */
+        void setEntityHandles(const Entity* entityHandles) noexcept {
+            mEntityHandles = entityHandles;
         }
 
     private:
-        Iterator mCurrent;
-        const Iterator mBegin;// iterator over entities
-        const Iterator mEnd;  // iterator over entities
-        const Predicate mPredicate;
-        const GetPointersFunc mGetPointersFunc;
-        std::function<std::size_t(std::size_t)> mIndexTransformer{ nullptr };
-    };
-
-    template<typename Iterator, typename Predicate, typename GetPointersFunc>
-    class ComponentHolderPairIterator final {
-    public:
-        class MutablePair final {
-        public:
-            [[nodiscard]] void* get(std::size_t index) const noexcept {
-                assert(index < mPointers.size());
-                return mPointers[index];
-            }
-
-            [[nodiscard]] std::size_t index() const noexcept {
-                return mIndex;
+        void skipNonMatching() noexcept {
+            while (mCurrent != mEnd && !matches(*mCurrent)) {
+                ++mCurrent;
             }
-
-        private:
-            std::size_t mIndex;
-            std::vector<void*> mPointers;
-
-            friend class ComponentHolderPairIterator;
-        };
-
-    public:
-        using iterator_category = std::forward_iterator_tag;
-        using difference_type = std::ptrdiff_t;
-        using value_type = MutablePair;
-        using pointer = MutablePair;
-        using reference = MutablePair;
-
-    public:
-        ComponentHolderPairIterator(Iterator begin,
-                                    Iterator end,
-                                    Predicate predicate,
-                                    GetPointersFunc getPointersFunc,
-                                    std::size_t offset = 0)
-            : mCurrent{ begin + offset },
-              mBegin{ begin },
-              mEnd{ end },
-              mPredicate{ predicate },
-              mGetPointersFunc{ getPointersFunc } { }
-
-        [[nodiscard]] bool operator==(const ComponentHolderPairIterator& other) const noexcept {
-            return mBegin == other.mBegin && mEnd == other.mEnd && mCurrent == other.mCurrent;
-        }
-
-        [[nodiscard]] bool operator!=(const ComponentHolderPairIterator& other) const noexcept {
-            return !((*this) == other);
-        }
-
-        [[nodiscard]] value_type operator*() const noexcept {
-            using ranges::views::transform, ranges::to_vector;
-            MutablePair result;
-            result.mIndex = (mIndexTransformer == nullptr ? *mCurrent : mIndexTransformer(*mCurrent));
-            result.mPointers = mGetPointersFunc(*mCurrent);
-            return result;
         }
 
-        [[nodiscard]] pointer operator->() const noexcept { }
-
-        ComponentHolderPairIterator operator++(int) noexcept {// postfix
-            const auto copy{ *this };
-            ++(*this);
-            return copy;
-        }
-
-        ComponentHolderPairIterator& operator++() noexcept {// prefix
-            assert(mBegin != mEnd && "no more elements");
-            while (true) {
-                ++mCurrent;
-                if (mCurrent == mEnd || mPredicate(*mCurrent)) {
-                    break;
+        [[nodiscard]] bool matches(SparseSet::Index index) const noexcept {
+            for (std::size_t i = 0; i < mNumSparseSets; ++i) {
+                if (i != mDriver && !mSparseSets[i]->has(index)) {
+                    return false;
                 }
             }
-            return *this;
-        }
-
-        void setIndexTransformerFunc(std::function<std::size_t(std::size_t)> func) noexcept {
-            mIndexTransformer = std::move(func);
+            return true;
         }
 
     private:
-        Iterator mCurrent;
-        const Iterator mBegin;// iterator over entities
-        const Iterator mEnd;  // iterator over entities
-        const Predicate mPredicate;
-        const GetPointersFunc mGetPointersFunc;
-        std::function<std::size_t(std::size_t)> mIndexTransformer{ nullptr };
+        SparseSets mSparseSets;
+        std::size_t mNumSparseSets;
+        std::size_t mDriver{ 0 };// index of the smallest set which is used to drive the iteration
+        IndexIterator mCurrent{};
+        IndexIterator mEnd{};
+        const Entity* mEntityHandles{ nullptr };// indexed by sparse index
     };
 
+    using ComponentHolderPairIterator = BasicComponentHolderPairIterator<false>;
+    using ConstComponentHolderPairIterator = BasicComponentHolderPairIterator<true>;
+
 }// namespace c2k
\ No newline at end of file
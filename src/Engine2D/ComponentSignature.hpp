@@ -0,0 +1,169 @@
+//
+// Created by coder2k on 13.12.2021.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace c2k {
+
+    /* Set of component types with one bit per type identifier. The first 64 bits are stored inline and only
+     * signatures that contain higher type identifiers allocate, so there is no limit for the number of types. */
+    class ComponentSignature final {
+    public:
+        [[nodiscard]] bool test(std::size_t bit) const noexcept {
+            return (word(bit / bitsPerWord) & mask(bit)) != 0;
+        }
+
+        ComponentSignature& set(std::size_t bit) noexcept {
+            wordMutable(bit / bitsPerWord) |= mask(bit);
+            return *this;
+        }
+
+        ComponentSignature& reset(std::size_t bit) noexcept {
+            if (bit / bitsPerWord < numWords()) {
+                wordMutable(bit / bitsPerWord) &= ~mask(bit);
+            }
+            return *this;
+        }
+
+        ComponentSignature& reset() noexcept {
+            mFirstWord = 0;
+            mMoreWords.clear();
+            return *this;
+        }
+
+        [[nodiscard]] bool any() const noexcept {
+            return mFirstWord != 0 ||
+                   std::any_of(mMoreWords.cbegin(), mMoreWords.cend(), [](const auto word) { return word != 0; });
+        }
+
+        [[nodiscard]] bool none() const noexcept {
+            return !any();
+        }
+
+        [[nodiscard]] std::size_t count() const noexcept {
+            auto result = static_cast<std::size_t>(std::popcount(mFirstWord));
+            for (const auto word : mMoreWords) {
+                result += static_cast<std::size_t>(std::popcount(word));
+            }
+            return result;
+        }
+
+        // true if every bit of other is also set in this signature
+        [[nodiscard]] bool containsAll(const ComponentSignature& other) const noexcept {
+            for (std::size_t i = 0; i < other.numWords(); ++i) {
+                if ((word(i) & other.word(i)) != other.word(i)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        [[nodiscard]] bool intersects(const ComponentSignature& other) const noexcept {
+            const auto numCommonWords = std::min(numWords(), other.numWords());
+            for (std::size_t i = 0; i < numCommonWords; ++i) {
+                if ((word(i) & other.word(i)) != 0) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        // calls function(bit) for every set bit in ascending order
+        void forEachSetBit(auto&& function) const noexcept {
+            for (std::size_t i = 0; i < numWords(); ++i) {
+                auto remainingBits = word(i);
+                while (remainingBits != 0) {
+                    function(i * bitsPerWord + static_cast<std::size_t>(std::countr_zero(remainingBits)));
+                    remainingBits &= remainingBits - 1;
+                }
+            }
+        }
+
+        ComponentSignature& operator|=(const ComponentSignature& other) noexcept {
+            for (std::size_t i = 0; i < other.numWords(); ++i) {
+                if (other.word(i) != 0) {
+                    wordMutable(i) |= other.word(i);
+                }
+            }
+            return *this;
+        }
+
+        ComponentSignature& operator&=(const ComponentSignature& other) noexcept {
+            for (std::size_t i = 0; i < numWords(); ++i) {
+                wordMutable(i) &= other.word(i);
+            }
+            return *this;
+        }
+
+        // clears all bits that are set in other
+        ComponentSignature& subtract(const ComponentSignature& other) noexcept {
+            const auto numCommonWords = std::min(numWords(), other.numWords());
+            for (std::size_t i = 0; i < numCommonWords; ++i) {
+                wordMutable(i) &= ~other.word(i);
+            }
+            return *this;
+        }
+
+        [[nodiscard]] friend ComponentSignature operator|(ComponentSignature lhs,
+                                                            const ComponentSignature& rhs) noexcept {
+            return lhs |= rhs;
+        }
+
+        [[nodiscard]] friend ComponentSignature operator&(ComponentSignature lhs,
+                                                            const ComponentSignature& rhs) noexcept {
+            return lhs &= rhs;
+        }
+
+        // trailing words that are zero don't make a difference
+        [[nodiscard]] friend bool operator==(const ComponentSignature& lhs, const ComponentSignature& rhs) noexcept {
+            const auto numWords = std::max(lhs.numWords(), rhs.numWords());
+            for (std::size_t i = 0; i < numWords; ++i) {
+                if (lhs.word(i) != rhs.word(i)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+    private:
+        static constexpr std::size_t bitsPerWord = 64;
+
+        [[nodiscard]] static std::uint64_t mask(std::size_t bit) noexcept {
+            return std::uint64_t{ 1 } << (bit % bitsPerWord);
+        }
+
+        [[nodiscard]] std::size_t numWords() const noexcept {
+            return 1 + mMoreWords.size();
+        }
+
+        [[nodiscard]] std::uint64_t word(std::size_t index) const noexcept {
+            if (index == 0) {
+                return mFirstWord;
+            }
+            return index < numWords() ? mMoreWords[index - 1] : 0;
+        }
+
+        // grows the signature if necessary
+        [[nodiscard]] std::uint64_t& wordMutable(std::size_t index) noexcept {
+            if (index == 0) {
+                return mFirstWord;
+            }
+            if (index >= numWords()) {
+                mMoreWords.resize(index, 0);
+            }
+            return mMoreWords[index - 1];
+        }
+
+    private:
+        std::uint64_t mFirstWord{ 0 };
+        std::vector<std::uint64_t> mMoreWords;// words 1 and above
+    };
+
+}// namespace c2k
\ No newline at end of file
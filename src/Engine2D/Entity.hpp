@@ -4,9 +4,36 @@
 
 #pragma once
 
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
 namespace c2k {
 
-    using Entity = std::uint32_t;
+    /* Compile time layout of entity handles: the upper identifierBits bits hold the index of the entity,
+     * the remaining bits hold a generation that is increased whenever the index gets recycled. */
+    template<std::unsigned_integral HandleType, std::size_t identifierBitCount>
+    struct EntityTraits {
+        using Handle = HandleType;
+        // identifiers are used as sparse indices, so they are stored in the smallest fitting type
+        using Identifier = std::conditional_t<(identifierBitCount <= 32), std::uint32_t, std::uint64_t>;
+        static constexpr std::size_t identifierBits = identifierBitCount;
+        static constexpr std::size_t generationBits = std::numeric_limits<Handle>::digits - identifierBits;
+
+        static_assert(identifierBits > 0 && identifierBits < std::numeric_limits<Handle>::digits);
+    };
+
+#ifdef WIDE_ENTITY_HANDLES
+    // about 4 billion simultaneous entities, generations wrap after about 4 billion recycles of an identifier
+    using EntityLayout = EntityTraits<std::uint64_t, 32>;
+#else
+    // about 1 million simultaneous entities, generations wrap after 4096 recycles of an identifier
+    using EntityLayout = EntityTraits<std::uint32_t, 20>;
+#endif
+
+    using Entity = EntityLayout::Handle;
     constexpr Entity invalidEntity = std::numeric_limits<Entity>::max();
 
 }// namespace c2k
\ No newline at end of file
@@ -3,7 +3,10 @@
 //
 
 #include "EntityUtils.hpp"
+#include <algorithm>
 #include <cassert>
+#include <span>
+#include <vector>
 
 namespace c2k::EntityUtils {
 
@@ -28,4 +31,101 @@ namespace c2k::EntityUtils {
         return transformMatrix;
     }
 
-}// namespace c2k::EntityUtils
+    namespace {
+
+        // world matrix of the closest ancestor that has a cached world transform
+        [[nodiscard]] glm::mat4 parentWorldMatrix(const Registry& registry, Entity entity) noexcept {
+            while (registry.hasComponent<RelationshipComponent>(entity)) {
+                entity = registry.component<RelationshipComponent>(entity)->parent;
+                if (const auto cache = registry.component<WorldTransformComponent>(entity)) {
+                    return cache->matrix;
+                }
+            }
+            return glm::mat4{ 1.0f };
+        }
+
+        [[nodiscard]] bool hasDirtyAncestor(const Registry& registry,
+                                            Entity entity,
+                                            std::span<const Entity> sortedDirtyEntities) noexcept {
+            while (registry.hasComponent<RelationshipComponent>(entity)) {
+                entity = registry.component<RelationshipComponent>(entity)->parent;
+                if (std::binary_search(sortedDirtyEntities.begin(), sortedDirtyEntities.end(), entity)) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+    }// namespace
+
+    std::size_t updateWorldTransforms(Registry& registry) noexcept {
+        std::vector<Entity> dirtyEntities;
+        if (!registry.isChangeTrackingEnabled<TransformComponent>() ||
+            !registry.isChangeTrackingEnabled<RelationshipComponent>()) {
+            // there are no recorded changes yet, so everything has to be recalculated once
+            registry.enableChangeTracking<TransformComponent>();
+            registry.enableChangeTracking<RelationshipComponent>();
+            for (auto&& [entity, transform] : registry.components<TransformComponent>()) {
+                dirtyEntities.push_back(entity);
+            }
+        } else {
+            const auto& transformChanges = registry.changes<TransformComponent>();
+            const auto& relationshipChanges = registry.changes<RelationshipComponent>();
+            for (const auto changes : { transformChanges.added(), transformChanges.updated(),
+                                        transformChanges.removed(), relationshipChanges.added(),
+                                        relationshipChanges.removed() }) {
+                for (const auto entity : changes) {
+                    if (registry.isEntityAlive(entity)) {
+                        dirtyEntities.push_back(entity);
+                    }
+                }
+            }
+        }
+        std::sort(dirtyEntities.begin(), dirtyEntities.end());
+        dirtyEntities.erase(std::unique(dirtyEntities.begin(), dirtyEntities.end()), dirtyEntities.end());
+
+        // attach and remove caches first, so that no storage gets reallocated during the traversal
+        for (const auto entity : dirtyEntities) {
+            const bool hasTransform = registry.hasComponent<TransformComponent>(entity);
+            const bool hasCache = registry.hasComponent<WorldTransformComponent>(entity);
+            if (hasTransform && !hasCache) {
+                registry.attachComponent(entity, WorldTransformComponent{});
+            } else if (!hasTransform && hasCache) {
+                registry.removeComponent<WorldTransformComponent>(entity);
+            }
+        }
+
+        struct PendingEntity {
+            Entity entity;
+            glm::mat4 parentMatrix;
+        };
+        std::vector<PendingEntity> pendingEntities;
+        std::size_t numVisitedEntities = 0;
+        for (const auto dirtyEntity : dirtyEntities) {
+            // the subtree of a dirty ancestor contains this entity already
+            if (hasDirtyAncestor(registry, dirtyEntity, dirtyEntities)) {
+                continue;
+            }
+            pendingEntities.push_back(PendingEntity{ dirtyEntity, parentWorldMatrix(registry, dirtyEntity) });
+            while (!pendingEntities.empty()) {
+                const auto current = pendingEntities.back();
+                pendingEntities.pop_back();
+                ++numVisitedEntities;
+                // entities without transform pass the matrix of their parent through
+                auto matrix = current.parentMatrix;
+                if (const auto transform = registry.component<TransformComponent>(current.entity)) {
+                    matrix = current.parentMatrix * transform->matrix();
+                    if (auto cache = registry.componentMutable<WorldTransformComponent>(current.entity)) {
+                        cache->matrix = matrix;
+                    }
+                }
+                for (auto child = registry.firstChild(current.entity); child != invalidEntity;
+                     child = registry.nextSibling(child)) {
+                    pendingEntities.push_back(PendingEntity{ child, matrix });
+                }
+            }
+        }
+        return numVisitedEntities;
+    }
+
+}// namespace c2k::EntityUtils
\ No newline at end of file
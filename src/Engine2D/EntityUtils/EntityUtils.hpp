@@ -6,10 +6,19 @@
 
 #include "Entity.hpp"
 #include "Registry.hpp"
+#include <cstddef>
 #include <glm/glm.hpp>
 
 namespace c2k::EntityUtils {
 
     [[nodiscard]] glm::mat4 getGlobalTransform(Registry& registry, Entity entity) noexcept;
 
+    /* Updates the WorldTransformComponent of every entity with a TransformComponent (attaching it if
+     * necessary). Only the subtrees of entities whose TransformComponent or RelationshipComponent has been
+     * added, removed or updated are visited. The first call enables change tracking for these component types
+     * and recalculates everything. Call it every frame before Registry::clearChanges(), otherwise changes get
+     * lost. Modifications through iteration have to be reported via Registry::markUpdated().
+     * Returns the number of visited entities. */
+    std::size_t updateWorldTransforms(Registry& registry) noexcept;
+
 }
@@ -24,8 +24,10 @@ namespace c2k {
             Iterator(Iterator&& other) {
                 mAddress = other.mAddress;
                 mStepSize = other.mStepSize;
+                mIndex = other.mIndex;
                 other.mAddress = nullptr;
                 other.mStepSize = 0;
+                other.mIndex = 0;
             }
 
             Iterator& operator=(const Iterator& other) noexcept {
@@ -34,6 +36,7 @@ namespace c2k {
                 }
                 mAddress = other.mAddress;
                 mStepSize = other.mStepSize;
+                mIndex = other.mIndex;
                 return *this;
             }
 
@@ -43,7 +46,8 @@ namespace c2k {
             }
 
             [[nodiscard]] Iterator operator+(std::size_t increment) noexcept {
-                return Iterator{ static_cast<std::uint8_t*>(mAddress) + increment * mStepSize, mStepSize };
+                return Iterator{ static_cast<std::uint8_t*>(mAddress) + increment * mStepSize, mStepSize,
+                                 mIndex + increment };
             }
 
             Iterator operator++(int) noexcept {// postfix
@@ -54,18 +58,17 @@ namespace c2k {
 
             Iterator& operator++() noexcept {// prefix
                 mAddress = (static_cast<std::uint8_t*>(mAddress) + mStepSize);
+                ++mIndex;
                 return *this;
             }
 
             difference_type operator-(const Iterator& other) noexcept {
-                return static_cast<difference_type>(static_cast<std::uint8_t*>(mAddress) -
-                                                    static_cast<std::uint8_t*>(other.mAddress)) /
-                       mStepSize;
+                return static_cast<difference_type>(mIndex) - static_cast<difference_type>(other.mIndex);
             }
 
             [[nodiscard]] bool operator==(const Iterator& other) const noexcept {
                 assert(mStepSize == other.mStepSize);
-                return mAddress == other.mAddress;
+                return mAddress == other.mAddress && mIndex == other.mIndex;
             }
 
             [[nodiscard]] bool operator!=(const Iterator& other) const noexcept {
@@ -75,6 +78,7 @@ namespace c2k {
             friend void swap(Iterator& lhs, Iterator& rhs) noexcept {
                 std::swap(lhs.mAddress, rhs.mAddress);
                 std::swap(lhs.mStepSize, rhs.mStepSize);
+                std::swap(lhs.mIndex, rhs.mIndex);
             }
 
             [[nodiscard]] reference operator*() const noexcept {
@@ -86,11 +90,15 @@ namespace c2k {
             }
 
         protected:
-            Iterator(void* address, std::size_t stepSize) noexcept : mAddress{ address }, mStepSize{ stepSize } { }
+            Iterator(void* address, std::size_t stepSize, std::size_t index) noexcept
+                : mAddress{ address },
+                  mStepSize{ stepSize },
+                  mIndex{ index } { }
 
         protected:
             void* mAddress{ nullptr };
             std::size_t mStepSize{ 0 };
+            std::size_t mIndex{ 0 };// zero-sized elements all share one address, so positions are tracked explicitly
 
             friend class c2k::TypeErasedVector;
         };// Iterator
@@ -111,8 +119,10 @@ namespace c2k {
             ConstIterator(ConstIterator&& other) {
                 mAddress = other.mAddress;
                 mStepSize = other.mStepSize;
+                mIndex = other.mIndex;
                 other.mAddress = nullptr;
                 other.mStepSize = 0;
+                other.mIndex = 0;
             }
 
             ConstIterator& operator=(const ConstIterator& other) noexcept {
@@ -121,6 +131,7 @@ namespace c2k {
                 }
                 mAddress = other.mAddress;
                 mStepSize = other.mStepSize;
+                mIndex = other.mIndex;
                 return *this;
             }
 
@@ -130,7 +141,8 @@ namespace c2k {
             }
 
             [[nodiscard]] ConstIterator operator+(std::size_t increment) noexcept {
-                return ConstIterator{ static_cast<std::uint8_t*>(mAddress) + increment * mStepSize, mStepSize };
+                return ConstIterator{ static_cast<std::uint8_t*>(mAddress) + increment * mStepSize, mStepSize,
+                                      mIndex + increment };
             }
 
             ConstIterator operator++(int) noexcept {// postfix
@@ -141,18 +153,17 @@ namespace c2k {
 
             ConstIterator& operator++() noexcept {// prefix
                 mAddress = (static_cast<std::uint8_t*>(mAddress) + mStepSize);
+                ++mIndex;
                 return *this;
             }
 
             difference_type operator-(const ConstIterator& other) noexcept {
-                return static_cast<difference_type>(static_cast<std::uint8_t*>(mAddress) -
-                                                    static_cast<std::uint8_t*>(other.mAddress)) /
-                       mStepSize;
+                return static_cast<difference_type>(mIndex) - static_cast<difference_type>(other.mIndex);
             }
 
             [[nodiscard]] bool operator==(const ConstIterator& other) const noexcept {
                 assert(mStepSize == other.mStepSize);
-                return mAddress == other.mAddress;
+                return mAddress == other.mAddress && mIndex == other.mIndex;
             }
 
             [[nodiscard]] bool operator!=(const ConstIterator& other) const noexcept {
@@ -162,6 +173,7 @@ namespace c2k {
             friend void swap(ConstIterator& lhs, ConstIterator& rhs) noexcept {
                 std::swap(lhs.mAddress, rhs.mAddress);
                 std::swap(lhs.mStepSize, rhs.mStepSize);
+                std::swap(lhs.mIndex, rhs.mIndex);
             }
 
             [[nodiscard]] reference operator*() const noexcept {
@@ -173,11 +185,15 @@ namespace c2k {
             }
 
         protected:
-            ConstIterator(void* address, std::size_t stepSize) noexcept : mAddress{ address }, mStepSize{ stepSize } { }
+            ConstIterator(void* address, std::size_t stepSize, std::size_t index) noexcept
+                : mAddress{ address },
+                  mStepSize{ stepSize },
+                  mIndex{ index } { }
 
         protected:
             void* mAddress{ nullptr };
             std::size_t mStepSize{ 0 };
+            std::size_t mIndex{ 0 };// zero-sized elements all share one address, so positions are tracked explicitly
 
             friend class c2k::TypeErasedVector;
         };// ConstIterator
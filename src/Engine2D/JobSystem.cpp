@@ -0,0 +1,117 @@
+//
+// Created by coder2k on 04.12.2021.
+//
+
+#include "JobSystem.hpp"
+#include <algorithm>
+#include <cassert>
+
+namespace c2k {
+
+    JobSystem::JobSystem(std::size_t numWorkers) noexcept {
+        mQueues.reserve(numWorkers + 1);
+        for (std::size_t i = 0; i < numWorkers + 1; ++i) {
+            mQueues.push_back(std::make_unique<JobQueue>());
+        }
+        mWorkers.reserve(numWorkers);
+        for (std::size_t i = 0; i < numWorkers; ++i) {
+            mWorkers.emplace_back([this, i](std::stop_token stopToken) { workerLoop(stopToken, i); });
+        }
+    }
+
+    JobSystem::~JobSystem() noexcept {
+        for (auto& worker : mWorkers) {
+            worker.request_stop();
+        }
+        mWakeUp.notify_all();
+        mWorkers.clear();// joins all workers
+    }
+
+    void JobSystem::schedule(Job job, JobCounter& counter) noexcept {
+        counter.fetch_add(1, std::memory_order_relaxed);
+        auto& queue = *mQueues[queueIndexOfCurrentThread()];
+        {
+            std::scoped_lock lock{ queue.mutex };
+            queue.jobs.push_back(QueuedJob{ std::move(job), &counter });
+        }
+        mNumPendingJobs.fetch_add(1, std::memory_order_release);
+        {
+            // prevents the wake up to get lost between the check and the wait of a worker
+            std::scoped_lock lock{ mSleepMutex };
+        }
+        mWakeUp.notify_one();
+    }
+
+    void JobSystem::wait(const JobCounter& counter) noexcept {
+        waitUntil([&counter] { return counter.load(std::memory_order_acquire) == 0; });
+    }
+
+    bool JobSystem::runPendingJob() noexcept {
+        const auto queueIndex = queueIndexOfCurrentThread();
+        QueuedJob queuedJob;
+        if (!popOwnJob(queueIndex, queuedJob) && !stealJob(queueIndex, queuedJob)) {
+            return false;
+        }
+        mNumPendingJobs.fetch_sub(1, std::memory_order_relaxed);
+        queuedJob.job();
+        if (queuedJob.counter->fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            // the counter may already be destroyed by now
+            notifyWaitingThreads();
+        }
+        return true;
+    }
+
+    void JobSystem::notifyWaitingThreads() noexcept {
+        {
+            // prevents the notification to get lost between the check and the wait of a waiting thread
+            std::scoped_lock lock{ mSleepMutex };
+        }
+        mWakeUp.notify_all();
+    }
+
+    std::size_t JobSystem::defaultNumWorkers() noexcept {
+        const auto numHardwareThreads = std::thread::hardware_concurrency();
+        return numHardwareThreads > 1 ? numHardwareThreads - 1 : 1;
+    }
+
+    void JobSystem::workerLoop(std::stop_token stopToken, std::size_t queueIndex) noexcept {
+        sCurrentJobSystem = this;
+        sCurrentQueueIndex = queueIndex;
+        while (!stopToken.stop_requested()) {
+            if (runPendingJob()) {
+                continue;
+            }
+            std::unique_lock lock{ mSleepMutex };
+            mWakeUp.wait(lock, stopToken, [this] { return mNumPendingJobs.load(std::memory_order_acquire) > 0; });
+        }
+    }
+
+    std::size_t JobSystem::queueIndexOfCurrentThread() const noexcept {
+        return sCurrentJobSystem == this ? sCurrentQueueIndex : mQueues.size() - 1;
+    }
+
+    bool JobSystem::popOwnJob(std::size_t queueIndex, QueuedJob& result) noexcept {
+        auto& queue = *mQueues[queueIndex];
+        std::scoped_lock lock{ queue.mutex };
+        if (queue.jobs.empty()) {
+            return false;
+        }
+        result = std::move(queue.jobs.back());
+        queue.jobs.pop_back();
+        return true;
+    }
+
+    bool JobSystem::stealJob(std::size_t thiefIndex, QueuedJob& result) noexcept {
+        for (std::size_t offset = 1; offset < mQueues.size(); ++offset) {
+            auto& queue = *mQueues[(thiefIndex + offset) % mQueues.size()];
+            std::scoped_lock lock{ queue.mutex };
+            if (!queue.jobs.empty()) {
+                result = std::move(queue.jobs.front());
+                queue.jobs.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+
+}// namespace c2k
\ No newline at end of file
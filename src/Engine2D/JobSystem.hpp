@@ -0,0 +1,96 @@
+//
+// Created by coder2k on 04.12.2021.
+//
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace c2k {
+
+    // number of unfinished jobs of a batch, JobSystem::wait() returns as soon as it reaches zero
+    using JobCounter = std::atomic<std::size_t>;
+
+    /* Fixed pool of worker threads with one job queue per worker. Workers take jobs from the back of
+     * their own queue and steal from the front of other queues once they run dry. Threads that wait
+     * for a counter execute pending jobs and only sleep once there are none left. */
+    class JobSystem final {
+    public:
+        using Job = std::function<void()>;
+
+    public:
+        explicit JobSystem(std::size_t numWorkers = defaultNumWorkers()) noexcept;
+        JobSystem(const JobSystem&) = delete;
+        JobSystem(JobSystem&&) = delete;
+        ~JobSystem() noexcept;
+        JobSystem& operator=(const JobSystem&) = delete;
+        JobSystem& operator=(JobSystem&&) = delete;
+
+        // the counter gets incremented immediately and decremented after the job has finished
+        void schedule(Job job, JobCounter& counter) noexcept;
+        void wait(const JobCounter& counter) noexcept;
+        // executes a single pending job (if any) on the calling thread
+        bool runPendingJob() noexcept;
+
+        /* Executes pending jobs on the calling thread until condition() holds and sleeps while there are
+         * none. Whoever makes the condition hold has to call notifyWaitingThreads() afterwards. */
+        template<typename Condition>
+        void waitUntil(Condition&& condition) noexcept {
+            while (!condition()) {
+                if (runPendingJob()) {
+                    continue;
+                }
+                std::unique_lock lock{ mSleepMutex };
+                mWakeUp.wait(lock, [this, &condition] {
+                    return condition() || mNumPendingJobs.load(std::memory_order_acquire) > 0;
+                });
+            }
+        }
+
+        void notifyWaitingThreads() noexcept;
+
+        [[nodiscard]] std::size_t numWorkers() const noexcept {
+            return mWorkers.size();
+        }
+
+        // one worker per hardware thread except the one of the main thread
+        [[nodiscard]] static std::size_t defaultNumWorkers() noexcept;
+
+    private:
+        struct QueuedJob {
+            Job job;
+            JobCounter* counter{ nullptr };
+        };
+
+        struct JobQueue {
+            std::mutex mutex;
+            std::deque<QueuedJob> jobs;
+        };
+
+    private:
+        void workerLoop(std::stop_token stopToken, std::size_t queueIndex) noexcept;
+        [[nodiscard]] std::size_t queueIndexOfCurrentThread() const noexcept;
+        [[nodiscard]] bool popOwnJob(std::size_t queueIndex, QueuedJob& result) noexcept;
+        [[nodiscard]] bool stealJob(std::size_t thiefIndex, QueuedJob& result) noexcept;
+
+    private:
+        // one queue per worker and a last one that is shared by all other threads
+        std::vector<std::unique_ptr<JobQueue>> mQueues;
+        std::atomic<std::size_t> mNumPendingJobs{ 0 };
+        std::mutex mSleepMutex;
+        std::condition_variable_any mWakeUp;
+        std::vector<std::jthread> mWorkers;
+        static thread_local inline const JobSystem* sCurrentJobSystem{ nullptr };
+        static thread_local inline std::size_t sCurrentQueueIndex{ 0 };
+    };
+
+}// namespace c2k
\ No newline at end of file
@@ -0,0 +1,75 @@
+//
+// Created by coder2k on 13.12.2021.
+//
+
+#include "OpenGLRenderBackend.hpp"
+#include "Texture.hpp"
+#include "GLDataUsagePattern.hpp"
+#include <gsl/gsl>
+#include <array>
+
+namespace c2k {
+
+    OpenGLRenderBackend::OpenGLRenderBackend(GLsizeiptr vertexBufferCapacityInBytes,
+                                             GLsizeiptr indexBufferCapacityInBytes,
+                                             GLsizeiptr instanceBufferCapacityInBytes) noexcept
+        : mVertexBuffer{ GLDataUsagePattern::StreamDraw, vertexBufferCapacityInBytes, indexBufferCapacityInBytes },
+          mInstanceBuffer{ GLDataUsagePattern::StreamDraw, instanceBufferCapacityInBytes } {
+        constexpr std::array<GLuint, 6> quadIndices{ 0, 1, 2, 0, 2, 3 };
+        mInstanceBuffer.submitIndexData(quadIndices.cbegin(), quadIndices.cend());
+    }
+
+    std::size_t OpenGLRenderBackend::numTextureSlots() const noexcept {
+        return static_cast<std::size_t>(Texture::getTextureUnitCount());
+    }
+
+    void OpenGLRenderBackend::setVertexAttributeLayout(std::span<const VertexAttributeDefinition> attributes,
+                                                       std::size_t stride) noexcept {
+        mVertexBuffer.setVertexAttributeLayout(attributes, VertexAttributeRate::PerVertex,
+                                               gsl::narrow_cast<GLsizei>(stride));
+    }
+
+    void OpenGLRenderBackend::submitVertexData(std::span<const std::byte> vertexData) noexcept {
+        mVertexBuffer.submitVertexData(vertexData);
+    }
+
+    void OpenGLRenderBackend::submitIndexData(std::span<const std::byte> indexData, GLenum indexType) noexcept {
+        mVertexBuffer.submitIndexData(indexData, indexType);
+    }
+
+    void OpenGLRenderBackend::bindShaderProgram(const ShaderProgram& shaderProgram) noexcept {
+        shaderProgram.bind();
+    }
+
+    void OpenGLRenderBackend::setUniform(const ShaderProgram& shaderProgram,
+                                         std::size_t uniformNameHash,
+                                         const glm::mat4& matrix) noexcept {
+        shaderProgram.setUniform(uniformNameHash, matrix);
+    }
+
+    void OpenGLRenderBackend::bindTexture(GLuint textureName, GLint textureUnit) noexcept {
+        Texture::bind(textureName, textureUnit);
+    }
+
+    void OpenGLRenderBackend::drawIndexed() noexcept {
+        mVertexBuffer.bind();
+        glDrawElements(GL_TRIANGLES, gsl::narrow_cast<GLsizei>(mVertexBuffer.indicesCount()),
+                       mVertexBuffer.indexType(), nullptr);
+    }
+
+    void OpenGLRenderBackend::setInstanceAttributeLayout(
+            std::span<const VertexAttributeDefinition> attributes) noexcept {
+        mInstanceBuffer.setVertexAttributeLayout(attributes, VertexAttributeRate::PerInstance);
+    }
+
+    void OpenGLRenderBackend::submitInstanceData(std::span<const std::byte> instanceData) noexcept {
+        mInstanceBuffer.submitVertexData(instanceData);
+    }
+
+    void OpenGLRenderBackend::drawInstancedQuads(std::size_t numInstances) noexcept {
+        mInstanceBuffer.bind();
+        glDrawElementsInstanced(GL_TRIANGLES, gsl::narrow_cast<GLsizei>(mInstanceBuffer.indicesCount()),
+                                GL_UNSIGNED_INT, nullptr, gsl::narrow_cast<GLsizei>(numInstances));
+    }
+
+}// namespace c2k
\ No newline at end of file
@@ -0,0 +1,38 @@
+//
+// Created by coder2k on 13.12.2021.
+//
+
+#pragma once
+
+#include "RenderBackend.hpp"
+#include "VertexBuffer.hpp"
+
+namespace c2k {
+
+    class OpenGLRenderBackend final : public RenderBackend {
+    public:
+        OpenGLRenderBackend(GLsizeiptr vertexBufferCapacityInBytes,
+                            GLsizeiptr indexBufferCapacityInBytes,
+                            GLsizeiptr instanceBufferCapacityInBytes) noexcept;
+
+        [[nodiscard]] std::size_t numTextureSlots() const noexcept override;
+        void setVertexAttributeLayout(std::span<const VertexAttributeDefinition> attributes,
+                                      std::size_t stride) noexcept override;
+        void submitVertexData(std::span<const std::byte> vertexData) noexcept override;
+        void submitIndexData(std::span<const std::byte> indexData, GLenum indexType) noexcept override;
+        void bindShaderProgram(const ShaderProgram& shaderProgram) noexcept override;
+        void setUniform(const ShaderProgram& shaderProgram,
+                        std::size_t uniformNameHash,
+                        const glm::mat4& matrix) noexcept override;
+        void bindTexture(GLuint textureName, GLint textureUnit) noexcept override;
+        void drawIndexed() noexcept override;
+        void setInstanceAttributeLayout(std::span<const VertexAttributeDefinition> attributes) noexcept override;
+        void submitInstanceData(std::span<const std::byte> instanceData) noexcept override;
+        void drawInstancedQuads(std::size_t numInstances) noexcept override;
+
+    private:
+        VertexBuffer mVertexBuffer;
+        VertexBuffer mInstanceBuffer;// its index buffer contains the indices of a single quad
+    };
+
+}// namespace c2k
\ No newline at end of file
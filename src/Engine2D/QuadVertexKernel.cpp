@@ -0,0 +1,274 @@
+//
+// Created by coder2k on 13.12.2021.
+//
+
+#include "QuadVertexKernel.hpp"
+#include <algorithm>
+#include <array>
+#include <cassert>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define QUAD_VERTEX_KERNEL_SSE2
+#include <immintrin.h>
+#endif
+
+namespace c2k {
+
+    QuadBatch::QuadBatch(std::size_t capacity) noexcept
+        : mCapacity{ capacity },
+          mXx(capacity),
+          mXy(capacity),
+          mYx(capacity),
+          mYy(capacity),
+          mTranslationX(capacity),
+          mTranslationY(capacity),
+          mTranslationZ(capacity),
+          mLeft(capacity),
+          mBottom(capacity),
+          mRight(capacity),
+          mTop(capacity),
+          mColors(capacity),
+          mTexIndices(capacity) { }
+
+    void QuadBatch::add(const glm::mat4& transform, const Rect& textureRect, GLuint color, GLushort texIndex) noexcept {
+        assert(mSize < mCapacity && "The quad batch is full.");
+        mXx[mSize] = transform[0].x;
+        mXy[mSize] = transform[0].y;
+        mYx[mSize] = transform[1].x;
+        mYy[mSize] = transform[1].y;
+        mTranslationX[mSize] = transform[3].x;
+        mTranslationY[mSize] = transform[3].y;
+        mTranslationZ[mSize] = transform[3].z;
+        mLeft[mSize] = textureRect.left;
+        mBottom[mSize] = textureRect.bottom;
+        mRight[mSize] = textureRect.right;
+        mTop[mSize] = textureRect.top;
+        mColors[mSize] = color;
+        mTexIndices[mSize] = texIndex;
+        ++mSize;
+    }
+
+    namespace {
+        struct QuadArrays {
+            const float *xx, *xy, *yx, *yy;
+            const float *translationX, *translationY, *translationZ;
+            const float *left, *bottom, *right, *top;
+            const GLuint* colors;
+            const GLushort* texIndices;
+        };
+
+        /* The corners (-1, -1), (1, -1), (1, 1) and (-1, 1) of the unit quad are transformed into
+         * translation - (X + Y), translation + (X - Y), translation + (X + Y) and translation - (X - Y), where X
+         * and Y are the first two columns of the transform. */
+
+        // rounds like glm::packUnorm2x16()
+        [[nodiscard]] GLuint packTexCoords(float u, float v) noexcept {
+            const auto quantize = [](float value) {
+                return static_cast<GLuint>(std::clamp(value, 0.0f, 1.0f) * 65535.0f + 0.5f);
+            };
+            return quantize(u) | (quantize(v) << 16);
+        }
+
+        void generateScalar(const QuadArrays& quads, std::size_t quad, QuadVertex* vertices) noexcept {
+            const glm::vec3 translation{ quads.translationX[quad], quads.translationY[quad],
+                                         quads.translationZ[quad] };
+            const glm::vec3 sum{ quads.xx[quad] + quads.yx[quad], quads.xy[quad] + quads.yy[quad], 0.0f };
+            const glm::vec3 difference{ quads.xx[quad] - quads.yx[quad], quads.xy[quad] - quads.yy[quad], 0.0f };
+            const std::array positions{ translation - sum, translation + difference, translation + sum,
+                                        translation - difference };
+            const std::array texCoords{ packTexCoords(quads.left[quad], quads.bottom[quad]),
+                                        packTexCoords(quads.right[quad], quads.bottom[quad]),
+                                        packTexCoords(quads.right[quad], quads.top[quad]),
+                                        packTexCoords(quads.left[quad], quads.top[quad]) };
+            for (std::size_t corner = 0; corner < 4; ++corner) {
+                vertices[corner] = QuadVertex{ .position{ positions[corner] },
+                                               .color{ quads.colors[quad] },
+                                               .texCoords{ texCoords[corner] },
+                                               .texIndex{ quads.texIndices[quad] } };
+            }
+        }
+
+#ifdef QUAD_VERTEX_KERNEL_SSE2
+        // one SIMD lane per quad
+        struct FourQuads {
+            __m128 positionX[4];// per corner
+            __m128 positionY[4];// per corner
+            __m128 positionZ;
+            __m128 colors;// bit patterns of the packed colors
+            __m128i texCoords[4];// per corner
+            __m128i texIndices;// zero extended to 32 bits, which also zeroes the padding
+        };
+
+        [[nodiscard]] __m128i quantize(__m128 values) noexcept {
+            const auto clamped = _mm_min_ps(_mm_max_ps(values, _mm_setzero_ps()), _mm_set1_ps(1.0f));
+            return _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(clamped, _mm_set1_ps(65535.0f)), _mm_set1_ps(0.5f)));
+        }
+
+        [[nodiscard]] __m128i packTexCoords(__m128i u, __m128i v) noexcept {
+            return _mm_or_si128(u, _mm_slli_epi32(v, 16));
+        }
+
+        [[nodiscard]] FourQuads loadFourQuads(const QuadArrays& quads, std::size_t first) noexcept {
+            const auto load = [first](const float* values) { return _mm_loadu_ps(values + first); };
+            const auto translationX = load(quads.translationX);
+            const auto translationY = load(quads.translationY);
+            const auto sumX = _mm_add_ps(load(quads.xx), load(quads.yx));
+            const auto sumY = _mm_add_ps(load(quads.xy), load(quads.yy));
+            const auto differenceX = _mm_sub_ps(load(quads.xx), load(quads.yx));
+            const auto differenceY = _mm_sub_ps(load(quads.xy), load(quads.yy));
+            const auto left = quantize(load(quads.left));
+            const auto bottom = quantize(load(quads.bottom));
+            const auto right = quantize(load(quads.right));
+            const auto top = quantize(load(quads.top));
+            const auto texIndices = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(quads.texIndices + first));
+            return FourQuads{
+                .positionX{ _mm_sub_ps(translationX, sumX), _mm_add_ps(translationX, differenceX),
+                            _mm_add_ps(translationX, sumX), _mm_sub_ps(translationX, differenceX) },
+                .positionY{ _mm_sub_ps(translationY, sumY), _mm_add_ps(translationY, differenceY),
+                            _mm_add_ps(translationY, sumY), _mm_sub_ps(translationY, differenceY) },
+                .positionZ{ load(quads.translationZ) },
+                .colors{ _mm_castsi128_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(quads.colors + first))) },
+                .texCoords{ packTexCoords(left, bottom), packTexCoords(right, bottom), packTexCoords(right, top),
+                            packTexCoords(left, top) },
+                .texIndices{ _mm_unpacklo_epi16(texIndices, _mm_setzero_si128()) },
+            };
+        }
+
+        void storeFourQuads(const FourQuads& quads, QuadVertex* vertices) noexcept {
+            for (std::size_t corner = 0; corner < 4; ++corner) {
+                auto row0 = quads.positionX[corner];
+                auto row1 = quads.positionY[corner];
+                auto row2 = quads.positionZ;
+                auto row3 = quads.colors;
+                // afterwards, every row contains the position and the color of one vertex
+                _MM_TRANSPOSE4_PS(row0, row1, row2, row3);
+                const __m128 positionsAndColors[4]{ row0, row1, row2, row3 };
+                // texture coordinates, texture index and padding of two vertices each
+                const auto low = _mm_unpacklo_epi32(quads.texCoords[corner], quads.texIndices);
+                const auto high = _mm_unpackhi_epi32(quads.texCoords[corner], quads.texIndices);
+                const __m128i remainders[4]{ low, _mm_unpackhi_epi64(low, low), high, _mm_unpackhi_epi64(high, high) };
+                for (std::size_t quad = 0; quad < 4; ++quad) {
+                    auto& vertex = vertices[quad * 4 + corner];
+                    _mm_storeu_ps(&vertex.position.x, positionsAndColors[quad]);
+                    _mm_storel_epi64(reinterpret_cast<__m128i*>(&vertex.texCoords), remainders[quad]);
+                }
+            }
+        }
+#endif
+
+#ifdef __AVX2__
+        struct EightQuads {
+            __m256 positionX[4];
+            __m256 positionY[4];
+            __m256 positionZ;
+            __m256 colors;
+            __m256i texCoords[4];
+            __m256i texIndices;
+        };
+
+        [[nodiscard]] __m256i quantize(__m256 values) noexcept {
+            const auto clamped = _mm256_min_ps(_mm256_max_ps(values, _mm256_setzero_ps()), _mm256_set1_ps(1.0f));
+            return _mm256_cvttps_epi32(
+                    _mm256_add_ps(_mm256_mul_ps(clamped, _mm256_set1_ps(65535.0f)), _mm256_set1_ps(0.5f)));
+        }
+
+        [[nodiscard]] __m256i packTexCoords(__m256i u, __m256i v) noexcept {
+            return _mm256_or_si256(u, _mm256_slli_epi32(v, 16));
+        }
+
+        [[nodiscard]] EightQuads loadEightQuads(const QuadArrays& quads, std::size_t first) noexcept {
+            const auto load = [first](const float* values) { return _mm256_loadu_ps(values + first); };
+            const auto translationX = load(quads.translationX);
+            const auto translationY = load(quads.translationY);
+            const auto sumX = _mm256_add_ps(load(quads.xx), load(quads.yx));
+            const auto sumY = _mm256_add_ps(load(quads.xy), load(quads.yy));
+            const auto differenceX = _mm256_sub_ps(load(quads.xx), load(quads.yx));
+            const auto differenceY = _mm256_sub_ps(load(quads.xy), load(quads.yy));
+            const auto left = quantize(load(quads.left));
+            const auto bottom = quantize(load(quads.bottom));
+            const auto right = quantize(load(quads.right));
+            const auto top = quantize(load(quads.top));
+            const auto colors = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(quads.colors + first));
+            const auto texIndices = _mm_loadu_si128(reinterpret_cast<const __m128i*>(quads.texIndices + first));
+            return EightQuads{
+                .positionX{ _mm256_sub_ps(translationX, sumX), _mm256_add_ps(translationX, differenceX),
+                            _mm256_add_ps(translationX, sumX), _mm256_sub_ps(translationX, differenceX) },
+                .positionY{ _mm256_sub_ps(translationY, sumY), _mm256_add_ps(translationY, differenceY),
+                            _mm256_add_ps(translationY, sumY), _mm256_sub_ps(translationY, differenceY) },
+                .positionZ{ load(quads.translationZ) },
+                .colors{ _mm256_castsi256_ps(colors) },
+                .texCoords{ packTexCoords(left, bottom), packTexCoords(right, bottom), packTexCoords(right, top),
+                            packTexCoords(left, top) },
+                .texIndices{ _mm256_cvtepu16_epi32(texIndices) },
+            };
+        }
+
+        template<int half>
+        [[nodiscard]] __m128 halfOf(__m256 values) noexcept {
+            if constexpr (half == 0) {
+                return _mm256_castps256_ps128(values);
+            } else {
+                return _mm256_extractf128_ps(values, 1);
+            }
+        }
+
+        template<int half>
+        [[nodiscard]] __m128i halfOf(__m256i values) noexcept {
+            if constexpr (half == 0) {
+                return _mm256_castsi256_si128(values);
+            } else {
+                return _mm256_extracti128_si256(values, 1);
+            }
+        }
+
+        // the lower half contains the first four quads
+        template<int half>
+        [[nodiscard]] FourQuads halfOf(const EightQuads& quads) noexcept {
+            FourQuads result;
+            for (std::size_t corner = 0; corner < 4; ++corner) {
+                result.positionX[corner] = halfOf<half>(quads.positionX[corner]);
+                result.positionY[corner] = halfOf<half>(quads.positionY[corner]);
+                result.texCoords[corner] = halfOf<half>(quads.texCoords[corner]);
+            }
+            result.positionZ = halfOf<half>(quads.positionZ);
+            result.colors = halfOf<half>(quads.colors);
+            result.texIndices = halfOf<half>(quads.texIndices);
+            return result;
+        }
+#endif
+    }// namespace
+
+    void generateQuadVertices(const QuadBatch& quads, std::span<QuadVertex> vertices) noexcept {
+        assert(vertices.size() >= quads.size() * 4 && "Not enough space for the vertices.");
+        const QuadArrays arrays{ .xx{ quads.mXx.data() },
+                                 .xy{ quads.mXy.data() },
+                                 .yx{ quads.mYx.data() },
+                                 .yy{ quads.mYy.data() },
+                                 .translationX{ quads.mTranslationX.data() },
+                                 .translationY{ quads.mTranslationY.data() },
+                                 .translationZ{ quads.mTranslationZ.data() },
+                                 .left{ quads.mLeft.data() },
+                                 .bottom{ quads.mBottom.data() },
+                                 .right{ quads.mRight.data() },
+                                 .top{ quads.mTop.data() },
+                                 .colors{ quads.mColors.data() },
+                                 .texIndices{ quads.mTexIndices.data() } };
+        std::size_t quad = 0;
+#ifdef __AVX2__
+        for (; quad + 8 <= quads.size(); quad += 8) {
+            const auto eightQuads = loadEightQuads(arrays, quad);
+            storeFourQuads(halfOf<0>(eightQuads), &vertices[quad * 4]);
+            storeFourQuads(halfOf<1>(eightQuads), &vertices[(quad + 4) * 4]);
+        }
+#endif
+#ifdef QUAD_VERTEX_KERNEL_SSE2
+        for (; quad + 4 <= quads.size(); quad += 4) {
+            storeFourQuads(loadFourQuads(arrays, quad), &vertices[quad * 4]);
+        }
+#endif
+        for (; quad < quads.size(); ++quad) {
+            generateScalar(arrays, quad, &vertices[quad * 4]);
+        }
+    }
+
+}// namespace c2k
\ No newline at end of file
@@ -0,0 +1,69 @@
+//
+// Created by coder2k on 13.12.2021.
+//
+
+#pragma once
+
+#include "Rect.hpp"
+#include "IncludeGLM.hpp"
+#include <glad/glad.h>
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace c2k {
+
+    struct QuadVertex {
+        glm::vec3 position;
+        GLuint color;// RGBA8
+        GLuint texCoords;// two 16 bit normalized values, see glm::packUnorm2x16()
+        GLushort texIndex;
+        GLushort padding{ 0 };
+    };
+    static_assert(offsetof(QuadVertex, color) == 3 * sizeof(GLfloat));
+    static_assert(offsetof(QuadVertex, texCoords) == 4 * sizeof(GLfloat));
+    static_assert(sizeof(QuadVertex) == 6 * sizeof(GLfloat));
+
+    /* Structure of arrays with one element per quad. This lets generateQuadVertices() load the same attribute
+     * of several quads into a single SIMD register. */
+    class QuadBatch final {
+    public:
+        explicit QuadBatch(std::size_t capacity) noexcept;
+
+        // only the 2D affine part (and the z translation) of the transform is used
+        void add(const glm::mat4& transform, const Rect& textureRect, GLuint color, GLushort texIndex) noexcept;
+
+        void clear() noexcept {
+            mSize = 0;
+        }
+
+        [[nodiscard]] std::size_t size() const noexcept {
+            return mSize;
+        }
+
+        [[nodiscard]] std::size_t capacity() const noexcept {
+            return mCapacity;
+        }
+
+        [[nodiscard]] bool empty() const noexcept {
+            return mSize == 0;
+        }
+
+    private:
+        std::size_t mSize{ 0 };
+        std::size_t mCapacity;
+        // first and second column of the transform
+        std::vector<float> mXx, mXy, mYx, mYy;
+        std::vector<float> mTranslationX, mTranslationY, mTranslationZ;
+        std::vector<float> mLeft, mBottom, mRight, mTop;
+        std::vector<GLuint> mColors;
+        std::vector<GLushort> mTexIndices;
+
+        friend void generateQuadVertices(const QuadBatch& quads, std::span<QuadVertex> vertices) noexcept;
+    };
+
+    /* Writes the four vertices of every quad (counter-clockwise, starting at the bottom left corner). Uses AVX2
+     * or SSE2 if the compiler targets them and falls back to scalar code otherwise. */
+    void generateQuadVertices(const QuadBatch& quads, std::span<QuadVertex> vertices) noexcept;
+
+}// namespace c2k
\ No newline at end of file
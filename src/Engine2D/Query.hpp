@@ -0,0 +1,37 @@
+//
+// Created by coder2k on 11.12.2021.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <limits>
+
+namespace c2k {
+
+    // excludes all entities with any of the given components from a query
+    template<typename... Components>
+    struct Without { };
+
+    /* Handle to a query that has been registered via Registry::registerQuery(). The registry keeps the
+     * list of matching entities up to date whenever components get attached or removed. */
+    template<typename... Components>
+    class Query final {
+    public:
+        Query() noexcept = default;
+        explicit Query(std::size_t index) noexcept : mIndex{ index } { }
+
+        [[nodiscard]] std::size_t index() const noexcept {
+            return mIndex;
+        }
+
+        [[nodiscard]] bool isValid() const noexcept {
+            return mIndex != invalidIndex;
+        }
+
+    private:
+        static constexpr std::size_t invalidIndex = std::numeric_limits<std::size_t>::max();
+        std::size_t mIndex{ invalidIndex };
+    };
+
+}// namespace c2k
\ No newline at end of file
@@ -0,0 +1,118 @@
+//
+// Created by coder2k on 13.12.2021.
+//
+
+#include "RecordingRenderBackend.hpp"
+
+namespace c2k {
+
+    RecordingRenderBackend::RecordingRenderBackend(std::size_t numTextureSlots) noexcept
+        : mNumTextureSlots{ numTextureSlots } { }
+
+    RecordingRenderBackend::~RecordingRenderBackend() {
+        // the names have never been created by OpenGL, so they must not be deleted
+        for (auto& texture : mTextures) {
+            texture->mName = 0U;
+        }
+        for (auto& shaderProgram : mShaderPrograms) {
+            shaderProgram->mName = 0U;
+        }
+    }
+
+    void RecordingRenderBackend::setVertexAttributeLayout(std::span<const VertexAttributeDefinition>,
+                                                          std::size_t stride) noexcept {
+        mCommands.push_back(Command{ .type{ CommandType::SetVertexAttributeLayout }, .stride{ stride } });
+    }
+
+    void RecordingRenderBackend::submitVertexData(std::span<const std::byte> vertexData) noexcept {
+        mVertexData.assign(vertexData.begin(), vertexData.end());
+        mCommands.push_back(Command{ .type{ CommandType::SubmitVertexData }, .numBytes{ vertexData.size() } });
+    }
+
+    void RecordingRenderBackend::submitIndexData(std::span<const std::byte> indexData, GLenum indexType) noexcept {
+        assert(indexType == GL_UNSIGNED_SHORT || indexType == GL_UNSIGNED_INT);
+        if (indexType == GL_UNSIGNED_SHORT) {
+            assert(indexData.size() % sizeof(GLushort) == 0);
+            std::vector<GLushort> indices(indexData.size() / sizeof(GLushort));
+            std::memcpy(indices.data(), indexData.data(), indexData.size());
+            mIndices.assign(indices.cbegin(), indices.cend());
+        } else {
+            assert(indexData.size() % sizeof(GLuint) == 0);
+            mIndices.resize(indexData.size() / sizeof(GLuint));
+            std::memcpy(mIndices.data(), indexData.data(), indexData.size());
+        }
+        mIndexType = indexType;
+        mCommands.push_back(Command{ .type{ CommandType::SubmitIndexData }, .numBytes{ indexData.size() } });
+    }
+
+    void RecordingRenderBackend::bindShaderProgram(const ShaderProgram& shaderProgram) noexcept {
+        mBoundShaderProgramName = shaderProgram.mName;
+        mCommands.push_back(Command{ .type{ CommandType::BindShaderProgram }, .name{ shaderProgram.mName } });
+    }
+
+    void RecordingRenderBackend::setUniform(const ShaderProgram& shaderProgram,
+                                            std::size_t uniformNameHash,
+                                            const glm::mat4&) noexcept {
+        mCommands.push_back(Command{ .type{ CommandType::SetUniform },
+                                     .name{ shaderProgram.mName },
+                                     .uniformNameHash{ uniformNameHash } });
+    }
+
+    void RecordingRenderBackend::bindTexture(GLuint textureName, GLint textureUnit) noexcept {
+        assert(textureUnit >= 0 && static_cast<std::size_t>(textureUnit) < mNumTextureSlots);
+        const auto slot = static_cast<std::size_t>(textureUnit);
+        if (slot >= mBoundTextureNames.size()) {
+            mBoundTextureNames.resize(slot + 1, 0U);
+        }
+        mBoundTextureNames[slot] = textureName;
+        mCommands.push_back(
+                Command{ .type{ CommandType::BindTexture }, .name{ textureName }, .textureUnit{ textureUnit } });
+    }
+
+    void RecordingRenderBackend::drawIndexed() noexcept {
+        mDrawCalls.push_back(DrawCall{ .shaderProgramName{ mBoundShaderProgramName },
+                                       .textureNames{ mBoundTextureNames },
+                                       .vertexData{ mVertexData },
+                                       .indices{ mIndices },
+                                       .indexType{ mIndexType } });
+        mCommands.push_back(Command{ .type{ CommandType::DrawIndexed } });
+    }
+
+    void RecordingRenderBackend::setInstanceAttributeLayout(std::span<const VertexAttributeDefinition>) noexcept {
+        mCommands.push_back(Command{ .type{ CommandType::SetInstanceAttributeLayout } });
+    }
+
+    void RecordingRenderBackend::submitInstanceData(std::span<const std::byte> instanceData) noexcept {
+        mInstanceData.assign(instanceData.begin(), instanceData.end());
+        mCommands.push_back(Command{ .type{ CommandType::SubmitInstanceData }, .numBytes{ instanceData.size() } });
+    }
+
+    void RecordingRenderBackend::drawInstancedQuads(std::size_t numInstances) noexcept {
+        mDrawCalls.push_back(DrawCall{ .shaderProgramName{ mBoundShaderProgramName },
+                                       .textureNames{ mBoundTextureNames },
+                                       .instanceData{ mInstanceData },
+                                       .numInstances{ numInstances } });
+        mCommands.push_back(Command{ .type{ CommandType::DrawInstancedQuads }, .numInstances{ numInstances } });
+    }
+
+    void RecordingRenderBackend::clearRecording() noexcept {
+        mCommands.clear();
+        mDrawCalls.clear();
+    }
+
+    const Texture& RecordingRenderBackend::createTexture(int width, int height) noexcept {
+        auto& texture = *mTextures.emplace_back(std::make_unique<Texture>());
+        texture.mName = mNextName++;
+        texture.mWidth = width;
+        texture.mHeight = height;
+        texture.mNumChannels = 4;
+        return texture;
+    }
+
+    ShaderProgram& RecordingRenderBackend::createShaderProgram() noexcept {
+        auto& shaderProgram = *mShaderPrograms.emplace_back(std::make_unique<ShaderProgram>());
+        shaderProgram.mName = mNextName++;
+        return shaderProgram;
+    }
+
+}// namespace c2k
\ No newline at end of file
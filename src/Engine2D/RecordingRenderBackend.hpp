@@ -0,0 +1,137 @@
+//
+// Created by coder2k on 13.12.2021.
+//
+
+#pragma once
+
+#include "RenderBackend.hpp"
+#include "Texture.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+namespace c2k {
+
+    /* Render backend that never touches a GPU but records every call into an inspectable stream. This allows
+     * testing and benchmarking the batching of the Renderer on headless machines. */
+    class RecordingRenderBackend final : public RenderBackend {
+    public:
+        enum class CommandType {
+            SetVertexAttributeLayout,
+            SubmitVertexData,
+            SubmitIndexData,
+            BindShaderProgram,
+            SetUniform,
+            BindTexture,
+            DrawIndexed,
+            SetInstanceAttributeLayout,
+            SubmitInstanceData,
+            DrawInstancedQuads,
+        };
+
+        struct Command {
+            CommandType type;
+            GLuint name{ 0U };// of the shader program or texture
+            GLint textureUnit{ 0 };
+            std::size_t uniformNameHash{ 0 };
+            std::size_t numBytes{ 0 };// of submitted data
+            std::size_t stride{ 0 };// of the vertex attribute layout
+            std::size_t numInstances{ 0 };
+        };
+
+        // the state of the pipeline at the time of a draw call
+        struct DrawCall {
+            GLuint shaderProgramName;
+            std::vector<GLuint> textureNames;// indexed by texture unit
+            std::vector<std::byte> vertexData{};// empty for instanced draw calls
+            std::vector<GLuint> indices{};// empty for instanced draw calls, widened if submitted as GLushort
+            GLenum indexType{ GL_UNSIGNED_INT };
+            std::vector<std::byte> instanceData{};// empty for non-instanced draw calls
+            std::size_t numInstances{ 0 };
+
+            template<typename VertexData>
+            [[nodiscard]] std::vector<VertexData> vertices() const noexcept {
+                return reinterpretData<VertexData>(vertexData);
+            }
+
+            template<typename InstanceData>
+            [[nodiscard]] std::vector<InstanceData> instances() const noexcept {
+                return reinterpretData<InstanceData>(instanceData);
+            }
+
+        private:
+            template<typename T>
+            [[nodiscard]] static std::vector<T> reinterpretData(const std::vector<std::byte>& data) noexcept {
+                assert(data.size() % sizeof(T) == 0 && "Data type mismatch.");
+                std::vector<T> result(data.size() / sizeof(T));
+                std::memcpy(result.data(), data.data(), data.size());
+                return result;
+            }
+        };
+
+    public:
+        explicit RecordingRenderBackend(std::size_t numTextureSlots = 16) noexcept;
+        RecordingRenderBackend(const RecordingRenderBackend&) = delete;
+        RecordingRenderBackend(RecordingRenderBackend&&) = delete;
+        ~RecordingRenderBackend() override;
+
+        RecordingRenderBackend& operator=(const RecordingRenderBackend&) = delete;
+        RecordingRenderBackend& operator=(RecordingRenderBackend&&) = delete;
+
+        [[nodiscard]] std::size_t numTextureSlots() const noexcept override {
+            return mNumTextureSlots;
+        }
+
+        void setVertexAttributeLayout(std::span<const VertexAttributeDefinition> attributes,
+                                      std::size_t stride) noexcept override;
+        void submitVertexData(std::span<const std::byte> vertexData) noexcept override;
+        void submitIndexData(std::span<const std::byte> indexData, GLenum indexType) noexcept override;
+        void bindShaderProgram(const ShaderProgram& shaderProgram) noexcept override;
+        void setUniform(const ShaderProgram& shaderProgram,
+                        std::size_t uniformNameHash,
+                        const glm::mat4& matrix) noexcept override;
+        void bindTexture(GLuint textureName, GLint textureUnit) noexcept override;
+        void drawIndexed() noexcept override;
+        void setInstanceAttributeLayout(std::span<const VertexAttributeDefinition> attributes) noexcept override;
+        void submitInstanceData(std::span<const std::byte> instanceData) noexcept override;
+        void drawInstancedQuads(std::size_t numInstances) noexcept override;
+
+        [[nodiscard]] const std::vector<Command>& commands() const noexcept {
+            return mCommands;
+        }
+
+        [[nodiscard]] const std::vector<DrawCall>& drawCalls() const noexcept {
+            return mDrawCalls;
+        }
+
+        [[nodiscard]] std::size_t count(CommandType type) const noexcept {
+            const auto hasType = [type](const Command& command) { return command.type == type; };
+            return static_cast<std::size_t>(std::count_if(mCommands.cbegin(), mCommands.cend(), hasType));
+        }
+
+        // forgets everything that has been recorded so far (e.g. between two benchmark iterations)
+        void clearRecording() noexcept;
+
+        /* Textures and shader programs with unique names that are never uploaded to a GPU. They are owned by
+         * the backend, so they stay valid as long as the backend (or the Renderer that owns it) lives. */
+        [[nodiscard]] const Texture& createTexture(int width = 1, int height = 1) noexcept;
+        [[nodiscard]] ShaderProgram& createShaderProgram() noexcept;
+
+    private:
+        std::size_t mNumTextureSlots;
+        std::vector<Command> mCommands;
+        std::vector<DrawCall> mDrawCalls;
+        std::vector<std::byte> mVertexData;
+        std::vector<GLuint> mIndices;
+        GLenum mIndexType{ GL_UNSIGNED_INT };
+        std::vector<std::byte> mInstanceData;
+        GLuint mBoundShaderProgramName{ 0U };
+        std::vector<GLuint> mBoundTextureNames;
+        GLuint mNextName{ 1U };
+        std::vector<std::unique_ptr<Texture>> mTextures;
+        std::vector<std::unique_ptr<ShaderProgram>> mShaderPrograms;
+    };
+
+}// namespace c2k
\ No newline at end of file
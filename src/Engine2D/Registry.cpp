@@ -9,22 +9,75 @@ namespace c2k {
 
     void Registry::destroyEntity(Entity entity) noexcept {
         assert(isEntityAlive(entity) && "The entity to remove must be alive.");
-        unparentEntitiesByParent(entity);
-        const auto index = getIndexFromEntity(entity);
-        deleteComponentsByEntityIndex(index);
-        increaseGeneration(mEntities[index]);
-        swapIdentifiers(mNextRecyclableEntity, mEntities[index]);
-        ++mNumRecyclableEntities;
+        destroyEntities(std::span{ &entity, 1 });
+    }
+
+    void Registry::destroyEntities(std::span<const Entity> entities) noexcept {
+        if (entities.empty()) {
+            return;
+        }
+        unparentEntitiesByParents(entities);
+        for (const auto entity : entities) {
+            assert(isEntityAlive(entity) && "The entity to remove must be alive.");
+            const auto identifier = getIdentifierBitsFromEntity(entity);
+            if (mSignatures[identifier].test(signatureBit<RelationshipComponent>())) {
+                unlinkFromParent(entity);
+            }
+            mSignatures[identifier].forEachSetBit([&](const std::size_t typeIdentifier) {
+                if (typeIdentifier >= mPendingRemovals.size()) {
+                    mPendingRemovals.resize(typeIdentifier + 1);
+                }
+                mPendingRemovals[typeIdentifier].push_back(identifier);
+                if (const auto tracker = changeTracker(typeIdentifier)) {
+                    tracker->recordRemoved(identifier, entity);
+                }
+            });
+            const auto removedComponents = mSignatures[identifier];
+            mSignatures[identifier].reset();
+            updateQueries(identifier, removedComponents);
+        }
+        // only the storages that actually contain components of the entities are visited
+        for (std::size_t typeIdentifier = 0; typeIdentifier < mPendingRemovals.size(); ++typeIdentifier) {
+            auto& identifiers = mPendingRemovals[typeIdentifier];
+            if (!identifiers.empty()) {
+                mComponentHolder.removeTypeErased(typeIdentifier, identifiers);
+                identifiers.clear();
+            }
+        }
+        // links are reset in a second pass since children unlink themselves from their (destroyed) parents
+        for (const auto entity : entities) {
+            const auto index = getIndexFromEntity(entity);
+            if (mEntities[index] != entity) {
+                continue;// duplicate handle, its identifier has already been recycled
+            }
+            mHierarchyLinks[index] = HierarchyLinks{};
+            increaseGeneration(mEntities[index]);
+            swapIdentifiers(mNextRecyclableEntity, mEntities[index]);
+            ++mNumRecyclableEntities;
+        }
     }
 
     void Registry::unparentEntitiesByParent(Entity parent) noexcept {
+        unparentEntitiesByParents(std::span{ &parent, 1 });
+    }
+
+    void Registry::unparentEntitiesByParents(std::span<const Entity> parents) noexcept {
+        std::vector<Entity> sortedParents;
+        if (parents.size() > 1) {
+            sortedParents.assign(parents.begin(), parents.end());
+            std::sort(sortedParents.begin(), sortedParents.end());
+        }
+        const auto isParent = [&](const Entity entity) {
+            return std::binary_search(sortedParents.cbegin(), sortedParents.cend(), entity);
+        };
         std::vector<Entity> entitiesToUnparent;
-        std::size_t total = 0;
-        for (auto&& [entity, relationship] : componentsMutable<RelationshipComponent>()) {
-            if (relationship.parent == parent) {
-                entitiesToUnparent.emplace_back(entity);
+        for (const auto parent : parents) {
+            for (auto child = firstChild(parent); child != invalidEntity; child = nextSibling(child)) {
+                // children that are in the list of parents themselves don't need to be unparented
+                if (!isParent(child)) {
+                    entitiesToUnparent.emplace_back(child);
+                }
             }
-            ++total;
         }
         for (const auto entityToUnparent : entitiesToUnparent) {
             const auto globalTransform = EntityUtils::getGlobalTransform(*this, entityToUnparent);
@@ -37,6 +90,240 @@ namespace c2k {
         }
     }
 
+    void Registry::destroySubtree(Entity root) noexcept {
+        std::vector<Entity> entitiesToDestroy;
+        collectSubtree(root, entitiesToDestroy);
+        destroyEntities(entitiesToDestroy);
+    }
+
+    std::vector<Entity> Registry::children(Entity parent) const noexcept {
+        std::vector<Entity> result;
+        for (auto child = firstChild(parent); child != invalidEntity; child = nextSibling(child)) {
+            result.push_back(child);
+        }
+        return result;
+    }
+
+    void Registry::linkToParent(Entity child, Entity parent) noexcept {
+        assert(isEntityAlive(child) && isEntityAlive(parent) && child != parent);
+        auto& childLinks = mHierarchyLinks[getIndexFromEntity(child)];
+        auto& parentLinks = mHierarchyLinks[getIndexFromEntity(parent)];
+        childLinks.previousSibling = invalidEntity;
+        childLinks.nextSibling = parentLinks.firstChild;
+        if (parentLinks.firstChild != invalidEntity) {
+            mHierarchyLinks[getIndexFromEntity(parentLinks.firstChild)].previousSibling = child;
+        }
+        parentLinks.firstChild = child;
+    }
+
+    void Registry::unlinkFromParent(Entity child) noexcept {
+        const auto parent = component<RelationshipComponent>(child)->parent;
+        auto& childLinks = mHierarchyLinks[getIndexFromEntity(child)];
+        if (childLinks.previousSibling != invalidEntity) {
+            mHierarchyLinks[getIndexFromEntity(childLinks.previousSibling)].nextSibling = childLinks.nextSibling;
+        } else {
+            auto& parentLinks = mHierarchyLinks[getIndexFromEntity(parent)];
+            assert(parentLinks.firstChild == child);
+            parentLinks.firstChild = childLinks.nextSibling;
+        }
+        if (childLinks.nextSibling != invalidEntity) {
+            mHierarchyLinks[getIndexFromEntity(childLinks.nextSibling)].previousSibling = childLinks.previousSibling;
+        }
+        childLinks.previousSibling = invalidEntity;
+        childLinks.nextSibling = invalidEntity;
+    }
+
+    void Registry::collectSubtree(Entity root, std::vector<Entity>& result) const noexcept {
+        // parents are always collected before their children
+        const auto firstIndex = result.size();
+        result.push_back(root);
+        for (auto i = firstIndex; i < result.size(); ++i) {
+            for (auto child = firstChild(result[i]); child != invalidEntity; child = nextSibling(child)) {
+                result.push_back(child);
+            }
+        }
+    }
+
+    std::vector<std::byte> Registry::snapshot() const noexcept {
+        static_assert(std::is_trivially_copyable_v<HierarchyLinks>);
+        SnapshotWriter writer;
+        writer.write(SnapshotHeader{ .formatVersion{ snapshotFormatVersion },
+                                     .entityHandleSize{ static_cast<std::uint32_t>(sizeof(Entity)) },
+                                     .identifierBits{ static_cast<std::uint32_t>(identifierBits) } });
+        writer.write(static_cast<std::uint64_t>(mEntities.size()));
+        writer.writeBytes(mEntities.data(), mEntities.size() * sizeof(Entity));
+        writer.writeBytes(mHierarchyLinks.data(), mHierarchyLinks.size() * sizeof(HierarchyLinks));
+        writer.write(static_cast<std::uint64_t>(mNumRecyclableEntities));
+        writer.write(mNextRecyclableEntity);
+        mComponentHolder.writeSnapshot(writer);
+        return writer.finish();
+    }
+
+    bool Registry::restore(std::span<const std::byte> snapshot, const AssetResolver& resolveAsset) noexcept {
+        SnapshotReader reader{ snapshot, resolveAsset };
+        if (!validateSnapshot(reader)) {
+            spdlog::error("Unable to restore snapshot.");
+            return false;
+        }
+        static_cast<void>(reader.read<SnapshotHeader>());
+        const auto numEntities = static_cast<std::size_t>(reader.read<std::uint64_t>());
+        mEntities.resize(numEntities);
+        mSignatures.resize(numEntities);
+        mHierarchyLinks.resize(numEntities);
+        reader.readBytes(mEntities.data(), numEntities * sizeof(Entity));
+        reader.readBytes(mHierarchyLinks.data(), numEntities * sizeof(HierarchyLinks));
+        mNumRecyclableEntities = static_cast<std::size_t>(reader.read<std::uint64_t>());
+        mNextRecyclableEntity = reader.read<Entity>();
+        if (mComponentHolder.size() < mEntities.capacity()) {
+            mComponentHolder.resize(mEntities.capacity());
+        }
+        mComponentHolder.readSnapshot(reader);
+        clearChanges();// the recorded changes refer to the state before restoring
+
+        // the type identifiers (and therefore the signature bits) may differ from the ones of the snapshot
+        std::fill(mSignatures.begin(), mSignatures.end(), ComponentSignature{});
+        const auto& sparseSets = mComponentHolder.sparseSets();
+        for (std::size_t typeIdentifier = 0; typeIdentifier < sparseSets.size(); ++typeIdentifier) {
+            if (sparseSets[typeIdentifier] == nullptr) {
+                continue;
+            }
+            for (const auto identifier : sparseSets[typeIdentifier]->indices()) {
+                mSignatures[identifier].set(typeIdentifier);
+            }
+        }
+        for (auto& query : mQueries) {
+            rebuildQuery(query);
+        }
+        return true;
+    }
+
+    bool Registry::validateSnapshot(SnapshotReader reader) const noexcept {
+        if (!reader.isValid()) {
+            spdlog::error("Snapshot is truncated.");
+            return false;
+        }
+        if (!reader.hasResolvedAllAssets()) {
+            spdlog::error("Snapshot references assets that couldn't be resolved.");
+            return false;
+        }
+        SnapshotHeader header{};
+        if (!reader.tryRead(header)) {
+            spdlog::error("Snapshot is truncated.");
+            return false;
+        }
+        if (header.formatVersion != snapshotFormatVersion) {
+            spdlog::error("Unsupported snapshot format version {} (expected {}).", header.formatVersion,
+                          snapshotFormatVersion);
+            return false;
+        }
+        if (header.entityHandleSize != sizeof(Entity) || header.identifierBits != identifierBits) {
+            spdlog::error("Snapshot uses {} byte entity handles with {} identifier bits, but this build uses {} "
+                          "byte entity handles with {} identifier bits.",
+                          header.entityHandleSize, header.identifierBits, sizeof(Entity), identifierBits);
+            return false;
+        }
+        std::uint64_t numEntities;
+        if (!reader.tryRead(numEntities)) {
+            spdlog::error("Snapshot is truncated.");
+            return false;
+        }
+        constexpr auto bytesPerEntity = sizeof(Entity) + sizeof(HierarchyLinks);
+        if (numEntities > (std::uint64_t{ 1 } << identifierBits) ||
+            numEntities * bytesPerEntity > reader.numRemainingBytes()) {
+            spdlog::error("Snapshot is truncated.");
+            return false;
+        }
+        std::vector<Entity> entities(static_cast<std::size_t>(numEntities));
+        std::vector<HierarchyLinks> hierarchyLinks(entities.size());
+        reader.readBytes(entities.data(), entities.size() * sizeof(Entity));
+        reader.readBytes(hierarchyLinks.data(), hierarchyLinks.size() * sizeof(HierarchyLinks));
+        std::uint64_t numRecyclableEntities;
+        Entity nextRecyclableEntity;
+        if (!reader.tryRead(numRecyclableEntities) || !reader.tryRead(nextRecyclableEntity)) {
+            spdlog::error("Snapshot is truncated.");
+            return false;
+        }
+
+        // the dead slots form a chain, each one holding the identifier of the next one
+        std::vector<bool> isAlive(entities.size(), true);
+        auto nextRecyclable = nextRecyclableEntity;
+        for (std::uint64_t i = 0; i < numRecyclableEntities; ++i) {
+            const auto index = getIndexFromEntity(nextRecyclable);
+            if (index >= entities.size() || !isAlive[index]) {
+                spdlog::error("Snapshot contains an invalid list of recyclable entities.");
+                return false;
+            }
+            isAlive[index] = false;
+            nextRecyclable = entities[index];
+        }
+        const auto isAliveEntity = [&](Entity entity) {
+            const auto index = getIndexFromEntity(entity);
+            return index < entities.size() && isAlive[index] && entities[index] == entity;
+        };
+        for (std::size_t index = 0; index < entities.size(); ++index) {
+            if (isAlive[index] && getIndexFromEntity(entities[index]) != index) {
+                spdlog::error("Snapshot contains an entity handle that doesn't match its slot {}.", index);
+                return false;
+            }
+        }
+
+        // every sibling list has to be a proper doubly linked list of alive entities
+        const auto isValidLink = [&](Entity link) {
+            return link == invalidEntity || isAliveEntity(link);
+        };
+        for (std::size_t index = 0; index < entities.size(); ++index) {
+            const auto& links = hierarchyLinks[index];
+            if (!isAlive[index]) {
+                if (links.firstChild != invalidEntity || links.previousSibling != invalidEntity ||
+                    links.nextSibling != invalidEntity) {
+                    spdlog::error("Snapshot contains hierarchy links of a destroyed entity.");
+                    return false;
+                }
+                continue;
+            }
+            if (!isValidLink(links.firstChild) || !isValidLink(links.previousSibling) ||
+                !isValidLink(links.nextSibling) ||
+                (links.firstChild != invalidEntity &&
+                 hierarchyLinks[getIndexFromEntity(links.firstChild)].previousSibling != invalidEntity) ||
+                (links.nextSibling != invalidEntity &&
+                 hierarchyLinks[getIndexFromEntity(links.nextSibling)].previousSibling != entities[index])) {
+                spdlog::error("Snapshot contains invalid hierarchy links for entity {}.", entities[index]);
+                return false;
+            }
+        }
+
+        const auto validateElements = [&](std::size_t typeIdentifier, const std::byte* elements, std::size_t count) {
+            if (typeIdentifier != signatureBit<RelationshipComponent>()) {
+                return true;
+            }
+            for (std::size_t i = 0; i < count; ++i) {
+                RelationshipComponent relationship;
+                std::memcpy(&relationship, elements + i * sizeof(RelationshipComponent), sizeof(relationship));
+                if (!isAliveEntity(relationship.parent)) {
+                    spdlog::error("Snapshot contains a RelationshipComponent with an invalid parent.");
+                    return false;
+                }
+            }
+            return true;
+        };
+        if (!mComponentHolder.validateSnapshot(reader, isAlive, validateElements)) {
+            return false;
+        }
+        if (reader.numRemainingBytes() != 0) {
+            spdlog::error("Snapshot contains unexpected trailing data.");
+            return false;
+        }
+        return true;
+    }
+
+    void Registry::clearChanges() noexcept {
+        for (const auto& tracker : mChangeTrackers) {
+            if (tracker != nullptr) {
+                tracker->clear();
+            }
+        }
+    }
+
     bool c2k::Registry::isEntityAlive(c2k::Entity entity) const noexcept {
         const auto index = getIndexFromEntity(entity);
         if (index >= mEntities.size()) {
@@ -58,7 +345,7 @@ namespace c2k {
     }
 
     c2k::Registry::Identifier c2k::Registry::getIdentifierBitsFromEntity(c2k::Entity entity) noexcept {
-        return Identifier{ (entity & identifierMask) >> generationBits };
+        return static_cast<Identifier>((entity & identifierMask) >> generationBits);
     }
     c2k::Registry::Generation c2k::Registry::getGenerationBitsFromEntity(c2k::Entity entity) noexcept {
         return Generation{ entity & generationMask };
@@ -66,7 +353,8 @@ namespace c2k {
 
     c2k::Entity c2k::Registry::entityFromIdentifierAndGeneration(c2k::Registry::Identifier identifier,
                                                                  c2k::Registry::Generation generation) noexcept {
-        return Entity{ (identifier << generationBits) | generation };
+        // generations wrap around instead of overflowing into the identifier bits
+        return Entity{ (static_cast<Entity>(identifier) << generationBits) | (generation & generationMask) };
     }
 
     void c2k::Registry::swapIdentifiers(c2k::Entity& entity1, c2k::Entity& entity2) noexcept {
@@ -86,13 +374,46 @@ namespace c2k {
         return static_cast<std::size_t>(getIdentifierBitsFromEntity(entity));
     }
 
-    void c2k::Registry::deleteComponentsByEntityIndex(std::size_t index) noexcept {
-        const auto entityIndex = gsl::narrow_cast<Entity>(index);
-        for (auto sparseSet : mComponentHolder.sparseSets()) {
-            if (sparseSet->has(entityIndex)) {
-                sparseSet->remove(entityIndex);
+    void Registry::updateQueries(Identifier identifier, const ComponentSignature& changedComponents) noexcept {
+        for (auto& query : mQueries) {
+            if (!changedComponents.intersects(query.required) && !changedComponents.intersects(query.excluded)) {
+                continue;
+            }
+            const bool shouldContain = query.accepts(mSignatures[identifier]);
+            if (shouldContain && !query.contains(identifier)) {
+                query.insert(identifier);
+            } else if (!shouldContain && query.contains(identifier)) {
+                query.erase(identifier);
+            }
+        }
+    }
+
+    void Registry::rebuildQuery(CachedQuery& query) const noexcept {
+        query.matches.clear();
+        query.positions.clear();
+        for (std::size_t index = 0; index < mSignatures.size(); ++index) {
+            if (query.accepts(mSignatures[index])) {
+                query.insert(gsl::narrow_cast<Identifier>(index));
             }
         }
     }
 
+    void Registry::CachedQuery::insert(Identifier identifier) noexcept {
+        assert(!contains(identifier));
+        if (identifier >= positions.size()) {
+            positions.resize(static_cast<std::size_t>(identifier) + 1, notContained);
+        }
+        positions[identifier] = matches.size();
+        matches.push_back(identifier);
+    }
+
+    void Registry::CachedQuery::erase(Identifier identifier) noexcept {
+        assert(contains(identifier));
+        const auto position = positions[identifier];
+        positions[matches.back()] = position;
+        matches[position] = matches.back();
+        matches.pop_back();
+        positions[identifier] = notContained;
+    }
+
 }// namespace c2k
\ No newline at end of file
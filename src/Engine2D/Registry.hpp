@@ -4,31 +4,54 @@
 
 #pragma once
 
+#include "ChangeTracker.hpp"
 #include "ComponentHolder.hpp"
+#include "ComponentSignature.hpp"
 #include "Entity.hpp"
 #include "TypeIdentifier.hpp"
 #include "Component.hpp"
+#include "Query.hpp"
 #include <tl/optional.hpp>
 #include <range/v3/all.hpp>
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <limits>
+#include <memory>
+#include <span>
+#include <tuple>
+#include <utility>
+#include <vector>
 
 namespace c2k {
 
     class Registry final {
     public:
         using Generation = Entity;
-        using Identifier = Entity;
+        using Identifier = EntityLayout::Identifier;
+        using ComponentSignature = c2k::ComponentSignature;// one bit per attached component type
+        static constexpr std::size_t defaultParallelGrainSize = 1024;
+        static constexpr std::uint32_t snapshotFormatVersion = 3;
 
     public:
         explicit Registry(std::size_t initialEntityCapacity = 0) : mComponentHolder{ initialEntityCapacity } {
             mEntities.reserve(initialEntityCapacity);
         }
 
+        // attaching a RelationshipComponent to an entity that already has one re-parents the entity
         template<typename Component>
         void attachComponent(Entity entity, const Component& component) noexcept {
-            mComponentHolder.template attach<Component>(getIdentifierBitsFromEntity(entity), component);
-            if constexpr (std::is_same_v<Component, ScriptComponent>) {
-                component.script->invokeOnAttach(entity);
+            if constexpr (std::is_same_v<Component, RelationshipComponent>) {
+                if (hasComponent<RelationshipComponent>(entity)) {
+                    // the entity has to leave the sibling list of its old parent first
+                    removeComponent<RelationshipComponent>(entity);
+                }
             }
+            const auto identifier = getIdentifierBitsFromEntity(entity);
+            mComponentHolder.template attach<Component>(identifier, component);
+            mSignatures[identifier].set(signatureBit<Component>());
+            updateQueries(identifier, ComponentSignature{}.set(signatureBit<Component>()));
+            notifyAttached(entity, component);
         }
 
         template<typename... Components>
@@ -39,111 +62,364 @@ namespace c2k {
 
         template<typename Component>
         [[nodiscard]] bool hasComponent(Entity entity) const noexcept {
-            return mComponentHolder.template has<Component>(getIdentifierBitsFromEntity(entity));
+            const auto identifier = getIdentifierBitsFromEntity(entity);
+            return identifier < mSignatures.size() && mSignatures[identifier].test(signatureBit<Component>());
         }
 
         template<typename Component>
         void removeComponent(Entity entity) noexcept {
-            mComponentHolder.template remove<Component>(getIdentifierBitsFromEntity(entity));
+            const auto identifier = getIdentifierBitsFromEntity(entity);
+            if constexpr (std::is_same_v<Component, RelationshipComponent>) {
+                unlinkFromParent(entity);
+            }
+            mComponentHolder.template remove<Component>(identifier);
+            mSignatures[identifier].reset(signatureBit<Component>());
+            updateQueries(identifier, ComponentSignature{}.set(signatureBit<Component>()));
+            if (const auto tracker = changeTracker(typeIdentifier<Component>())) {
+                tracker->recordRemoved(identifier, entity);
+            }
+        }
+
+        /* Starts recording which entities get the given component attached, removed or updated (see
+         * markUpdated() and patch()). The records are available via changes() until clearChanges(). */
+        template<typename Component>
+        void enableChangeTracking() noexcept {
+            const auto index = typeIdentifier<Component>();
+            if (index >= mChangeTrackers.size()) {
+                mChangeTrackers.resize(index + 1);
+            }
+            if (mChangeTrackers[index] == nullptr) {
+                mChangeTrackers[index] = std::make_unique<ChangeTracker>();
+            }
+        }
+
+        template<typename Component>
+        [[nodiscard]] bool isChangeTrackingEnabled() const noexcept {
+            return changeTracker(typeIdentifier<Component>()) != nullptr;
+        }
+
+        template<typename Component>
+        [[nodiscard]] const ChangeTracker& changes() const noexcept {
+            const auto tracker = changeTracker(typeIdentifier<Component>());
+            assert(tracker != nullptr && "Change tracking is not enabled for this component type.");
+            return *tracker;
+        }
+
+        // componentMutable() marks the component as updated, but modifications through iteration have to be marked
+        template<typename Component>
+        void markUpdated(Entity entity) noexcept {
+            assert(hasComponent<Component>(entity));
+            if (const auto tracker = changeTracker(typeIdentifier<Component>())) {
+                tracker->recordUpdated(getIdentifierBitsFromEntity(entity), entity);
+            }
+        }
+
+        // calls function(component&) and marks the component as updated
+        template<typename Component>
+        void patch(Entity entity, auto&& function) noexcept {
+            function(componentMutable<Component>(entity).value());
+            markUpdated<Component>(entity);
+        }
+
+        // has to be called once per frame after all observers have pulled their changes
+        void clearChanges() noexcept;
+
+        // contains the bit typeIdentifier<Component>() for every component the entity currently has
+        [[nodiscard]] const ComponentSignature& componentSignature(Entity entity) const noexcept {
+            assert(getIndexFromEntity(entity) < mSignatures.size());
+            return mSignatures[getIndexFromEntity(entity)];
         }
 
         template<typename Component>
-        [[nodiscard]] tl::optional<const Component&> component(Entity entity) const noexcept {
+        [[nodiscard]] tl::optional<ComponentReference<const Component>> component(Entity entity) const noexcept {
             if (!hasComponent<Component>(entity)) {
                 return {};
             }
             return mComponentHolder.template get<Component>(getIdentifierBitsFromEntity(entity));
         }
 
+        // counts as an update of the component if its changes are tracked
         template<typename Component>
-        [[nodiscard]] tl::optional<Component&> componentMutable(Entity entity) noexcept {
+        [[nodiscard]] tl::optional<ComponentReference<Component>> componentMutable(Entity entity) noexcept {
             if (!hasComponent<Component>(entity)) {
                 return {};
             }
-            return mComponentHolder.template getMutable<Component>(getIdentifierBitsFromEntity(entity));
+            const auto identifier = getIdentifierBitsFromEntity(entity);
+            if (const auto tracker = changeTracker(typeIdentifier<Component>())) {
+                tracker->recordUpdated(identifier, entity);
+            }
+            return mComponentHolder.template getMutable<Component>(identifier);
         }
 
         template<typename... Components>
         [[nodiscard]] auto componentsMutable() noexcept {
             using ranges::views::transform;
-            return mComponentHolder.template getMutable<Components...>() | transform([this](auto&& tuple) {
-                       return std::apply(
-                               [this](auto&& identifier, auto&&... rest) {
-                                   return std::forward_as_tuple(mEntities[identifier], rest...);
-                               },
-                               tuple);
-                   });
+            return mComponentHolder.template getMutable<Components...>() |
+                   transform([this](auto&& tuple) { return withEntityHandle(tuple); });
         }
 
         template<typename... Components>
         [[nodiscard]] auto components() const noexcept {
             using ranges::views::transform;
-            return mComponentHolder.template get<Components...>() | transform([this](auto&& tuple) {
-                       return std::apply(
-                               [this](auto&& identifier, auto&&... rest) {
-                                   return std::forward_as_tuple(mEntities[identifier], rest...);
-                               },
-                               tuple);
+            return mComponentHolder.template get<Components...>() |
+                   transform([this](auto&& tuple) { return withEntityHandle(tuple); });
+        }
+
+        /* Calls function for every entity that has all the given components. The function can either take
+         * (Entity, Components&...) or only (Components&...) - in the latter case the entity handles are not
+         * even looked up. Prefer this over components() in hot loops since it compiles to a plain loop.
+         * Components that are stored as structure of arrays are passed as ComponentReference proxies. */
+        template<typename... Components>
+        void each(auto&& function) noexcept {
+            if constexpr (std::invocable<decltype(function), Entity, ComponentReference<Components>&...>) {
+                mComponentHolder.template eachMutable<Components...>(
+                        [this, &function](const Identifier identifier, ComponentReference<Components>... components) {
+                            function(mEntities[identifier], components...);
+                        });
+            } else {
+                mComponentHolder.template eachMutable<Components...>(
+                        [&function](const Identifier, ComponentReference<Components>... components) {
+                            function(components...);
+                        });
+            }
+        }
+
+        /* Calls function(entity, components&...) for every entity that has all the given components. The
+         * entities are processed in chunks of grainSize on the job system (see setJobSystem()) and in no
+         * particular order.
+         * Contract for function (everything else is a data race):
+         *  - it may modify the components it gets passed, but no components of other entities (unless all
+         *    concurrent accesses to them are atomic)
+         *  - it may read storages of other component types as long as no other invocation writes them
+         *  - it must not change the structure of the registry (create or destroy entities, attach or
+         *    remove components) - record those changes into a CommandBuffer instead
+         *  - it must not call componentMutable() or markUpdated() for component types whose changes are tracked */
+        template<typename... Components>
+        void parallelEach(auto&& function, std::size_t grainSize = defaultParallelGrainSize) noexcept {
+            mComponentHolder.template parallelEachMutable<Components...>(
+                    [this, &function](const Identifier identifier, ComponentReference<Components>... components) {
+                        function(mEntities[identifier], components...);
+                    },
+                    grainSize, mJobSystem);
+        }
+
+        // parallelEach() runs on the calling thread only until a job system has been set
+        void setJobSystem(JobSystem* jobSystem) noexcept {
+            mJobSystem = jobSystem;
+        }
+
+        template<typename... Components>
+        void registerGroup() noexcept {
+            mComponentHolder.template registerGroup<Components...>();
+        }
+
+        /* Registers a persistent query for all entities that have every one of the given components and none
+         * of the excluded ones, e.g. registerQuery<A, B>(Without<C>{}). The matching entities are tracked
+         * incrementally, so iterating over the query never visits any other entity. Registering the same
+         * query twice yields the same handle. */
+        template<typename... Components, typename... Excluded>
+        requires(sizeof...(Components) > 0)
+        [[nodiscard]] Query<Components...> registerQuery(Without<Excluded...> = {}) noexcept {
+            CachedQuery query;
+            (query.required.set(signatureBit<Components>()), ...);
+            (query.excluded.set(signatureBit<Excluded>()), ...);
+            assert(!query.required.intersects(query.excluded) && "A component cannot be required and excluded.");
+            for (std::size_t i = 0; i < mQueries.size(); ++i) {
+                if (mQueries[i].required == query.required && mQueries[i].excluded == query.excluded) {
+                    return Query<Components...>{ i };
+                }
+            }
+            mQueries.push_back(std::move(query));
+            rebuildQuery(mQueries.back());
+            return Query<Components...>{ mQueries.size() - 1 };
+        }
+
+        template<typename... Components>
+        [[nodiscard]] std::size_t numMatches(const Query<Components...>& query) const noexcept {
+            return cachedQuery(query).matches.size();
+        }
+
+        template<typename... Components>
+        [[nodiscard]] auto queryMutable(const Query<Components...>& query) noexcept {
+            using ranges::views::transform;
+            return cachedQuery(query).matches | transform([this](const Identifier identifier) {
+                       return std::tuple<const Entity&, ComponentReference<Components>...>(
+                               mEntities[identifier], mComponentHolder.template getMutable<Components>(identifier)...);
                    });
         }
 
+        // like each<Components...>(function), but only visits the entities that match the query
+        template<typename... Components>
+        void each(const Query<Components...>& query, auto&& function) noexcept {
+            const auto& matches = cachedQuery(query).matches;
+            if (matches.empty()) {
+                return;
+            }
+            const auto& sparseSets = mComponentHolder.sparseSets();
+            const std::array<SparseSet*, sizeof...(Components)> storages{ sparseSets[typeIdentifier<Components>()]... };
+            const auto invoke = [&](const Identifier identifier, ComponentReference<Components>... components) {
+                if constexpr (std::invocable<decltype(function), Entity, ComponentReference<Components>&...>) {
+                    function(mEntities[identifier], components...);
+                } else {
+                    function(components...);
+                }
+            };
+            [&]<std::size_t... indices>(std::index_sequence<indices...>) {
+                for (const auto identifier : matches) {
+                    invoke(identifier, storages[indices]->template getMutable<Components>(identifier)...);
+                }
+            }(std::index_sequence_for<Components...>{});
+        }
+
+        /* Sorts the storage of the given component in place, so that iterating over it (or over its
+         * owning group) visits the components in the order of the comparator. */
+        template<typename Component>
+        void sort(auto&& compare, SortAlgorithm algorithm = SortAlgorithm::Standard) noexcept {
+            mComponentHolder.template sort<Component>(compare, algorithm);
+        }
+
+        // lets the storage of Follower iterate in the same order as the storage of Leader
+        template<typename Follower, typename Leader>
+        void followOrder() noexcept {
+            mComponentHolder.template followOrder<Follower, Leader>();
+        }
+
+        /* Contiguous array of a single member (e.g. &Component::velocity) of all components of a type that is
+         * stored as structure of arrays, in the same order as components<Component>(). Meant for systems that
+         * update one member of every component in a tight (vectorizable) loop. */
+        template<auto member>
+        [[nodiscard]] auto columnMutable() noexcept {
+            return mComponentHolder.template columnMutable<member>();
+        }
+
+        template<auto member>
+        [[nodiscard]] auto column() const noexcept {
+            return mComponentHolder.template column<member>();
+        }
+
+        template<typename... Components>
+        [[nodiscard]] auto groupMutable() noexcept {
+            using ranges::views::transform;
+            return mComponentHolder.template groupMutable<Components...>() |
+                   transform([this](auto&& tuple) { return withEntityHandle(tuple); });
+        }
+
+        template<typename... Components>
+        [[nodiscard]] auto group() const noexcept {
+            using ranges::views::transform;
+            return mComponentHolder.template group<Components...>() |
+                   transform([this](auto&& tuple) { return withEntityHandle(tuple); });
+        }
+
         template<typename Iterator>
         [[nodiscard]] auto componentsTypeErasedMutable(Iterator typeIdentifiersBegin, Iterator typeIdentifiersEnd) {
             auto&& [begin, end] = mComponentHolder.getTypeErasedMutable(typeIdentifiersBegin, typeIdentifiersEnd);
-            const auto transformerFunc = [this](std::size_t index) { return mEntities[index]; };
-            begin.setIndexTransformerFunc(transformerFunc);
-            end.setIndexTransformerFunc(transformerFunc);
+            begin.setEntityHandles(mEntities.data());
+            end.setEntityHandles(mEntities.data());
             return std::pair(begin, end);
         }
 
         template<typename Iterator>
         [[nodiscard]] auto componentsTypeErased(Iterator typeIdentifiersBegin, Iterator typeIdentifiersEnd) {
             auto&& [begin, end] = mComponentHolder.getTypeErased(typeIdentifiersBegin, typeIdentifiersEnd);
-            const auto transformerFunc = [this](std::size_t index) { return mEntities[index]; };
-            begin.setIndexTransformerFunc(transformerFunc);
-            end.setIndexTransformerFunc(transformerFunc);
+            begin.setEntityHandles(mEntities.data());
+            end.setEntityHandles(mEntities.data());
             return std::pair(begin, end);
         }
 
         template<typename... Components>
         Entity createEntity(Components... components) noexcept {
-            const auto entity = [&]() {
-                if (mNumRecyclableEntities > 0) {
-                    const auto index = getIndexFromEntity(mNextRecyclableEntity);
-                    swapIdentifiers(mEntities[index], mNextRecyclableEntity);
-                    --mNumRecyclableEntities;
-                    assert(static_cast<std::size_t>(getIdentifierBitsFromEntity(mEntities[index])) == index);
-                    return mEntities[index];
-                } else {
-                    const auto result = mEntities.emplace_back(entityFromIdentifierAndGeneration(
-                            Identifier{ gsl::narrow_cast<Entity>(mEntities.size()) }, Generation{ 0 }));
-                    if (mComponentHolder.size() < mEntities.capacity()) {
-                        // TODO: add option to deny resizing
-                        mComponentHolder.resize(mEntities.capacity());
-                    }
-                    return result;
-                }
-            }();// immediately invoked
+            const auto entity = acquireEntity();
             attachComponents(entity, components...);
             return entity;
         }
 
+        /* Creates count entities that all get a copy of the given components. Every storage is appended to
+         * in bulk and the cached queries are only matched once, since all new entities have the same signature. */
+        template<typename... Components>
+        std::vector<Entity> createEntities(std::size_t count, const Components&... components) noexcept {
+            std::vector<Entity> result;
+            result.reserve(count);
+            const auto numNewEntities = count - std::min(count, mNumRecyclableEntities);
+            mEntities.reserve(mEntities.size() + numNewEntities);
+            mSignatures.reserve(mEntities.size() + numNewEntities);
+            mHierarchyLinks.reserve(mEntities.size() + numNewEntities);
+            std::vector<Identifier> identifiers;
+            identifiers.reserve(count);
+            for (std::size_t i = 0; i < count; ++i) {
+                result.push_back(acquireEntity());
+                identifiers.push_back(getIdentifierBitsFromEntity(result.back()));
+            }
+            (mComponentHolder.template attachMany<Components>(identifiers, components), ...);
+            ComponentSignature signature;
+            (signature.set(signatureBit<Components>()), ...);
+            for (const auto identifier : identifiers) {
+                mSignatures[identifier] = signature;// acquired entities don't have any components
+            }
+            for (auto& query : mQueries) {
+                if (query.accepts(signature)) {
+                    for (const auto identifier : identifiers) {
+                        query.insert(identifier);
+                    }
+                }
+            }
+            if constexpr (sizeof...(Components) > 0) {
+                for (const auto entity : result) {
+                    (notifyAttached(entity, components), ...);
+                }
+            }
+            return result;
+        }
+
         void destroyEntity(Entity entity) noexcept;
 
+        /* Destroys all given entities (which must be alive, duplicates are only destroyed once). The components
+         * are removed storage by storage, so that every storage is only visited once. */
+        void destroyEntities(std::span<const Entity> entities) noexcept;
+
+        // destroys the given entity together with all of its (direct and indirect) children
+        void destroySubtree(Entity root) noexcept;
+
         void unparentEntitiesByParent(Entity parent) noexcept;
 
+        void unparentEntitiesByParents(std::span<const Entity> parents) noexcept;
+
+        /* The registry links all entities with a RelationshipComponent to their parent. Parents
+         * must only be changed by removing and re-attaching the RelationshipComponent. */
+        [[nodiscard]] Entity firstChild(Entity parent) const noexcept {
+            assert(isEntityAlive(parent));
+            return mHierarchyLinks[getIndexFromEntity(parent)].firstChild;
+        }
+
+        [[nodiscard]] Entity nextSibling(Entity child) const noexcept {
+            assert(isEntityAlive(child));
+            return mHierarchyLinks[getIndexFromEntity(child)].nextSibling;
+        }
+
+        [[nodiscard]] std::vector<Entity> children(Entity parent) const noexcept;
+
         template<typename... Components>
         std::size_t destroyEntitiesWithComponents() noexcept {
             std::vector<Entity> entitiesToDelete;
             for (const auto& tuple : components<Components...>()) {
                 entitiesToDelete.emplace_back(get<0>(tuple));
             }
-            for (const auto entity : entitiesToDelete) {
-                destroyEntity(entity);
-            }
+            destroyEntities(entitiesToDelete);
             return entitiesToDelete.size();
         }
 
+        /* Serializes all entities and components into a binary blob. Trivially copyable storages are
+         * copied as a whole, asset pointers are stored as GUIDs (see AssetReferences). */
+        [[nodiscard]] std::vector<std::byte> snapshot() const noexcept;
+
+        /* Replaces the whole state of the registry by the given snapshot. All component types and groups
+         * of the snapshot have to be registered (storages are matched by type hash). Without a resolver,
+         * the referenced assets have to live at the same addresses as when the snapshot was taken.
+         * The whole snapshot is validated first. If it is invalid (truncated, from another format version or
+         * entity layout, unknown component types, ...), the registry stays untouched and false is returned. */
+        [[nodiscard]] bool restore(std::span<const std::byte> snapshot,
+                                   const AssetResolver& resolveAsset = {}) noexcept;
+
         [[nodiscard]] bool isEntityAlive(Entity entity) const noexcept;
         [[nodiscard]] std::size_t numEntities() const noexcept;
         [[nodiscard]] std::size_t numEntitiesAlive() const noexcept;
@@ -174,25 +450,138 @@ namespace c2k {
             mComponentHolder.template registerType<T>();
         }
 
+        template<typename... Types>
+        void registerTypes(TypeList<Types...>) noexcept {
+            (registerType<Types>(), ...);
+        }
+
         [[nodiscard]] static Identifier getIdentifierBitsFromEntity(Entity entity) noexcept;
         [[nodiscard]] static Generation getGenerationBitsFromEntity(Entity entity) noexcept;
 
     private:
+        [[nodiscard]] Entity acquireEntity() noexcept {
+            if (mNumRecyclableEntities > 0) {
+                const auto index = getIndexFromEntity(mNextRecyclableEntity);
+                swapIdentifiers(mEntities[index], mNextRecyclableEntity);
+                --mNumRecyclableEntities;
+                assert(static_cast<std::size_t>(getIdentifierBitsFromEntity(mEntities[index])) == index);
+                return mEntities[index];
+            }
+            assert(mEntities.size() < (std::size_t{ 1 } << identifierBits) && "Too many entities for the layout.");
+            const auto result = mEntities.emplace_back(entityFromIdentifierAndGeneration(
+                    gsl::narrow_cast<Identifier>(mEntities.size()), Generation{ 0 }));
+            mSignatures.emplace_back();
+            mHierarchyLinks.emplace_back();
+            if (mComponentHolder.size() < mEntities.capacity()) {
+                // TODO: add option to deny resizing
+                mComponentHolder.resize(mEntities.capacity());
+            }
+            return result;
+        }
+
+        template<typename Component>
+        void notifyAttached(Entity entity, const Component& component) noexcept {
+            if (const auto tracker = changeTracker(typeIdentifier<Component>())) {
+                tracker->recordAdded(getIdentifierBitsFromEntity(entity), entity);
+            }
+            if constexpr (std::is_same_v<Component, RelationshipComponent>) {
+                linkToParent(entity, component.parent);
+            }
+            if constexpr (std::is_same_v<Component, ScriptComponent>) {
+                component.script->invokeOnAttach(entity);
+            }
+        }
+
+        // the signature grows with the type identifiers, so every type identifier can be used as a bit
+        template<typename Component>
+        [[nodiscard]] std::size_t signatureBit() const noexcept {
+            return typeIdentifier<Component>();
+        }
+
         [[nodiscard]] static Entity entityFromIdentifierAndGeneration(Identifier identifier,
                                                                       Generation generation) noexcept;
         static void swapIdentifiers(Entity& entity1, Entity& entity2) noexcept;
         static void increaseGeneration(Entity& entity) noexcept;
         [[nodiscard]] static std::size_t getIndexFromEntity(Entity entity) noexcept;
 
-        void deleteComponentsByEntityIndex(std::size_t index) noexcept;
+        void linkToParent(Entity child, Entity parent) noexcept;
+        void unlinkFromParent(Entity child) noexcept;
+        void collectSubtree(Entity root, std::vector<Entity>& result) const noexcept;
+
+        void updateQueries(Identifier identifier, const ComponentSignature& changedComponents) noexcept;
+
+        template<typename... Components>
+        [[nodiscard]] const auto& cachedQuery(const Query<Components...>& query) const noexcept {
+            assert(query.isValid() && query.index() < mQueries.size() && "The query has not been registered.");
+            return mQueries[query.index()];
+        }
+
+        // replaces the identifier in front of a view tuple by the entity handle, all other elements keep their type
+        template<typename Tuple>
+        [[nodiscard]] auto withEntityHandle(Tuple&& tuple) const noexcept {
+            using Elements = std::remove_cvref_t<Tuple>;
+            return [&]<std::size_t... indices>(std::index_sequence<indices...>) {
+                return std::tuple<const Entity&, std::tuple_element_t<indices + 1, Elements>...>(
+                        mEntities[std::get<0>(tuple)], std::get<indices + 1>(tuple)...);
+            }(std::make_index_sequence<std::tuple_size_v<Elements> - 1>{});
+        }
+
+        [[nodiscard]] ChangeTracker* changeTracker(std::size_t typeIdentifier) const noexcept {
+            return typeIdentifier < mChangeTrackers.size() ? mChangeTrackers[typeIdentifier].get() : nullptr;
+        }
+
+    private:
+        // snapshots can only be restored by builds with the same entity layout (see WIDE_ENTITY_HANDLES)
+        struct SnapshotHeader {
+            std::uint32_t formatVersion;
+            std::uint32_t entityHandleSize;
+            std::uint32_t identifierBits;
+        };
+
+        struct HierarchyLinks {
+            Entity firstChild{ invalidEntity };
+            Entity previousSibling{ invalidEntity };
+            Entity nextSibling{ invalidEntity };
+        };
+
+        struct CachedQuery {
+            static constexpr std::size_t notContained = std::numeric_limits<std::size_t>::max();
+
+            ComponentSignature required;
+            ComponentSignature excluded;
+            std::vector<Identifier> matches;
+            std::vector<std::size_t> positions;// indexed by identifier, position within matches
+
+            [[nodiscard]] bool accepts(const ComponentSignature& signature) const noexcept {
+                return signature.containsAll(required) && !signature.intersects(excluded);
+            }
+
+            [[nodiscard]] bool contains(Identifier identifier) const noexcept {
+                return identifier < positions.size() && positions[identifier] != notContained;
+            }
+
+            void insert(Identifier identifier) noexcept;
+            void erase(Identifier identifier) noexcept;
+        };
+
+    private:
+        void rebuildQuery(CachedQuery& query) const noexcept;
+        // reads ahead through the whole snapshot, so it works on a copy of the reader
+        [[nodiscard]] bool validateSnapshot(SnapshotReader reader) const noexcept;
 
     private:
-        static constexpr std::size_t identifierBits = sizeof(Entity) * 8 * 20 / 32;
-        static constexpr std::size_t generationBits = sizeof(Entity) * 8 - identifierBits;
+        static constexpr std::size_t identifierBits = EntityLayout::identifierBits;
+        static constexpr std::size_t generationBits = EntityLayout::generationBits;
         static constexpr Entity generationMask = std::numeric_limits<Entity>::max() >> identifierBits;
         static constexpr Entity identifierMask = std::numeric_limits<Entity>::max() << generationBits;
         ComponentHolder<Identifier> mComponentHolder;
         std::vector<Entity> mEntities;
+        std::vector<ComponentSignature> mSignatures;// indexed by identifier
+        std::vector<HierarchyLinks> mHierarchyLinks;// indexed by identifier
+        std::vector<CachedQuery> mQueries;
+        std::vector<std::unique_ptr<ChangeTracker>> mChangeTrackers;// indexed by type identifier, nullptr if disabled
+        std::vector<std::vector<Identifier>> mPendingRemovals;// indexed by type identifier, used by destroyEntities()
+        JobSystem* mJobSystem{ nullptr };
         std::size_t mNumRecyclableEntities{ 0 };
         Entity mNextRecyclableEntity{ invalidEntity };
     };
@@ -0,0 +1,47 @@
+//
+// Created by coder2k on 13.12.2021.
+//
+
+#pragma once
+
+#include "VertexAttributeDefinition.hpp"
+#include "ShaderProgram.hpp"
+#include "IncludeGLM.hpp"
+#include <glad/glad.h>
+#include <cstddef>
+#include <span>
+
+namespace c2k {
+
+    /* Everything the Renderer needs from the graphics API. The Renderer never talks to the GPU directly, so
+     * that its batching can also run without a GPU (see RecordingRenderBackend). Implementations manage a
+     * single streaming vertex buffer (plus its index buffer) and a streaming instance buffer. */
+    class RenderBackend {
+    public:
+        virtual ~RenderBackend() = default;
+
+        // number of textures that can be bound at the same time
+        [[nodiscard]] virtual std::size_t numTextureSlots() const noexcept = 0;
+
+        // the stride is the size of a single vertex (including padding)
+        virtual void setVertexAttributeLayout(std::span<const VertexAttributeDefinition> attributes,
+                                              std::size_t stride) noexcept = 0;
+        virtual void submitVertexData(std::span<const std::byte> vertexData) noexcept = 0;
+        // the index type is either GL_UNSIGNED_SHORT or GL_UNSIGNED_INT
+        virtual void submitIndexData(std::span<const std::byte> indexData, GLenum indexType) noexcept = 0;
+        virtual void bindShaderProgram(const ShaderProgram& shaderProgram) noexcept = 0;
+        virtual void setUniform(const ShaderProgram& shaderProgram,
+                                std::size_t uniformNameHash,
+                                const glm::mat4& matrix) noexcept = 0;
+        virtual void bindTexture(GLuint textureName, GLint textureUnit) noexcept = 0;
+        // draws triangles using all indices of the last index data submission
+        virtual void drawIndexed() noexcept = 0;
+
+        virtual void setInstanceAttributeLayout(std::span<const VertexAttributeDefinition> attributes) noexcept = 0;
+        virtual void submitInstanceData(std::span<const std::byte> instanceData) noexcept = 0;
+        /* Draws one quad per instance of the last instance data submission. The quads consist of the vertices
+         * 0 to 3 (in counter-clockwise order), so the vertex shader can look up the corners via gl_VertexID. */
+        virtual void drawInstancedQuads(std::size_t numInstances) noexcept = 0;
+    };
+
+}// namespace c2k
\ No newline at end of file
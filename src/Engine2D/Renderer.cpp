@@ -3,42 +3,81 @@
 //
 
 #include "Renderer.hpp"
+#include "QuadVertexKernel.hpp"
 #include "Component.hpp"
-#include "GLDataUsagePattern.hpp"
+#include "OpenGLRenderBackend.hpp"
 #include "ScopedTimer.hpp"
 #include "Hash/Hash.hpp"
 
 namespace c2k {
 
-    Renderer::Renderer(const Window& window)
-        : mVertexBuffer(GLDataUsagePattern::StreamDraw,
-                        maxCommandsPerBatch * 4ULL * sizeof(VertexData),
-                        maxCommandsPerBatch * 6ULL * sizeof(IndexData)),
-          mWindow{ window } {
-        mCommandBuffer.resize(maxCommandsPerBatch);
-        mVertexData.resize(maxCommandsPerBatch * 4ULL);
-        mIndexData.resize(maxCommandsPerBatch * 6ULL);
+    Renderer::Renderer(const Window& window, Mode mode)
+        : Renderer{ std::make_unique<OpenGLRenderBackend>(
+                            mode == Mode::Batched ? maxVerticesPerBatch * sizeof(VertexData) : 0ULL,
+                            mode == Mode::Batched ? maxIndexDataPerBatch * sizeof(IndexData) : 0ULL,
+                            mode == Mode::Instanced ? maxInstancesPerBatch * sizeof(InstanceData) : 0ULL),
+                    mode } {
+        mWindow = &window;
+    }
+
+    Renderer::Renderer(std::unique_ptr<RenderBackend> backend, Mode mode)
+        : mMode{ mode },
+          mQuads{ mode == Mode::Batched ? maxVerticesPerBatch / 4 : 0 },
+          mBackend{ std::move(backend) } {
+        // instanced batches are only limited by the number of texture slots, so the command buffer can be larger
+        const auto commandBufferSize = (mMode == Mode::Instanced ? maxInstancesPerBatch : maxCommandsPerBatch);
+        mCommandBuffer.resize(commandBufferSize);
+        mSortEntries.resize(commandBufferSize);
+        mSortScratchBuffer.resize(commandBufferSize);
+        if (mMode == Mode::Instanced) {
+            mInstanceData.resize(maxInstancesPerBatch);
+        } else {
+            mVertexData.resize(maxVerticesPerBatch);
+            mIndexData.reserve(maxIndexDataPerBatch);
+            for (std::size_t i = 0; i < maxVerticesPerBatch; i += 4) {
+                const auto offset = gsl::narrow_cast<GLushort>(i);
+                mIndexData.push_back(IndexData{ offset, gsl::narrow_cast<GLushort>(offset + 1),
+                                                gsl::narrow_cast<GLushort>(offset + 2) });
+                mIndexData.push_back(IndexData{ offset, gsl::narrow_cast<GLushort>(offset + 2),
+                                                gsl::narrow_cast<GLushort>(offset + 3) });
+            }
+        }
         mCommandIterator = mCommandBuffer.begin();
-        mVertexIterator = mVertexData.begin();
-        mIndexIterator = mIndexData.begin();
-        mCurrentTextureNames.reserve(std::min(Texture::getTextureUnitCount(), 32));
+        mInstanceIterator = mInstanceData.begin();
+        mCurrentTextureNames.reserve(std::min(mBackend->numTextureSlots(), maxTextureSlots));
         spdlog::info("GPU is capable of binding {} textures at a time.", mCurrentTextureNames.capacity());
-        mVertexBuffer.setVertexAttributeLayout(VertexAttributeDefinition{ 3, GL_FLOAT, false },
-                                               VertexAttributeDefinition{ 4, GL_FLOAT, false },
-                                               VertexAttributeDefinition{ 2, GL_FLOAT, false },
-                                               VertexAttributeDefinition{ 1, GL_UNSIGNED_INT, false });
+        if (mMode == Mode::Instanced) {
+            const std::array instanceAttributes{ VertexAttributeDefinition{ 2, GL_FLOAT, false },
+                                                 VertexAttributeDefinition{ 2, GL_FLOAT, false },
+                                                 VertexAttributeDefinition{ 3, GL_FLOAT, false },
+                                                 VertexAttributeDefinition{ 4, GL_FLOAT, false },
+                                                 VertexAttributeDefinition{ 4, GL_UNSIGNED_BYTE, true },
+                                                 VertexAttributeDefinition{ 1, GL_UNSIGNED_INT, false } };
+            mBackend->setInstanceAttributeLayout(instanceAttributes);
+        } else {
+            const std::array vertexAttributes{ VertexAttributeDefinition{ 3, GL_FLOAT, false },
+                                               VertexAttributeDefinition{ 4, GL_UNSIGNED_BYTE, true },
+                                               VertexAttributeDefinition{ 2, GL_UNSIGNED_SHORT, true },
+                                               VertexAttributeDefinition{ 1, GL_UNSIGNED_SHORT, false } };
+            mBackend->setVertexAttributeLayout(vertexAttributes, sizeof(VertexData));
+        }
     }
 
     void Renderer::beginFrame(const glm::mat4& viewMatrix) noexcept {
-        mVertexIterator = mVertexData.begin();
-        mIndexIterator = mIndexData.begin();
+        assert(mWindow != nullptr && "The renderer has been created without a window.");
+        beginFrame(viewMatrix, mWindow->framebufferSize());
+    }
+
+    void Renderer::beginFrame(const glm::mat4& viewMatrix, const WindowSize& framebufferSize) noexcept {
+        mQuads.clear();
+        mInstanceIterator = mInstanceData.begin();
         mRenderStats = RenderStats{};
-        mCurrentViewProjectionMatrix = CameraComponent::projectionMatrix(mWindow.framebufferSize()) * viewMatrix;
+        mCurrentViewProjectionMatrix = CameraComponent::projectionMatrix(framebufferSize) * viewMatrix;
     }
 
     void Renderer::endFrame() noexcept {
         flushCommandBuffer();
-        flushVertexAndIndexData();
+        flushBatch();
         //spdlog::info("Drawing {} quads in {} batches", mRenderStats.numTriangles / 2, mRenderStats.numBatches);
     }
 
@@ -48,21 +87,28 @@ namespace c2k {
                             ShaderProgram& shader,
                             const Texture& texture,
                             const Rect& textureRect,
-                            const Color& color) noexcept {
+                            const Color& color,
+                            Layer layer) noexcept {
         drawQuad(glm::scale(glm::rotate(glm::translate(glm::mat4{ 1.0f }, translation), rotationAngle,
                                         glm::vec3{ 0.0f, 0.0f, 1.0f }),
                             glm::vec3{ scale.x, scale.y, 1.0f }),
-                 shader, texture, textureRect, color);
+                 shader, texture, textureRect, color, layer);
     }
 
     void Renderer::drawQuad(const glm::mat4& transformMatrix,
                             ShaderProgram& shader,
                             const Texture& texture,
                             const Rect& textureRect,
-                            const Color& color) noexcept {
+                            const Color& color,
+                            Layer layer) noexcept {
         if (mCommandIterator == mCommandBuffer.end()) {
             flushCommandBuffer();
         }
+        const auto commandIndex = static_cast<std::size_t>(mCommandIterator - mCommandBuffer.begin());
+        const auto clipSpaceDepth = (mCurrentViewProjectionMatrix * transformMatrix[3]).z;
+        mSortEntries[commandIndex] =
+                SortEntry{ .key{ sortKey(layer, isTranslucent(color), clipSpaceDepth, shader, texture) },
+                           .commandIndex{ gsl::narrow_cast<std::uint32_t>(commandIndex) } };
         *mCommandIterator++ = RenderCommand{ .transformMatrix{ transformMatrix },
                                              .textureRect{ textureRect },
                                              .color{ color },
@@ -70,119 +116,173 @@ namespace c2k {
                                              .texture{ &texture } };
     }
 
+    std::uint64_t Renderer::sortKey(Layer layer,
+                                    bool translucent,
+                                    float clipSpaceDepth,
+                                    const ShaderProgram& shader,
+                                    const Texture& texture) noexcept {
+        constexpr std::uint64_t maxName = 0xFFFF;
+        constexpr std::uint64_t maxDepth = (1ULL << 23) - 1;
+        assert(shader.mName <= maxName && texture.mName <= maxName && "Name does not fit into the sort key.");
+        // opaque quads rely on the depth test, so ignoring their depth keeps their batches as large as possible
+        std::uint64_t depth = 0ULL;
+        if (translucent) {
+            // back to front, i.e. starting at the far plane (depth 1 in clip space)
+            const auto distanceFromFarPlane = std::clamp((1.0f - clipSpaceDepth) * 0.5f, 0.0f, 1.0f);
+            depth = static_cast<std::uint64_t>(distanceFromFarPlane * static_cast<float>(maxDepth));
+        }
+        return (std::uint64_t{ layer } << 56) | (std::uint64_t{ translucent } << 55) | (depth << 32) |
+               (std::uint64_t{ shader.mName } << 16) | std::uint64_t{ texture.mName };
+    }
+
+    void Renderer::sortCommands(std::size_t numCommands) noexcept {
+        // LSD radix sort with one pass per byte of the key
+        auto source = std::span{ mSortEntries.data(), numCommands };
+        auto destination = std::span{ mSortScratchBuffer.data(), numCommands };
+        // bytes that are the same for all keys (e.g. the layer) don't change the order, so their passes are skipped
+        std::uint64_t differingBits = 0ULL;
+        for (const auto& entry : source) {
+            differingBits |= entry.key ^ source.front().key;
+        }
+        bool resultIsInScratchBuffer = false;
+        for (std::uint64_t shift = 0; shift < 64; shift += 8) {
+            if (((differingBits >> shift) & 0xFF) == 0) {
+                continue;
+            }
+            std::array<std::size_t, 256> offsets{};
+            for (const auto& entry : source) {
+                ++offsets[(entry.key >> shift) & 0xFF];
+            }
+            std::exclusive_scan(offsets.cbegin(), offsets.cend(), offsets.begin(), std::size_t{ 0 });
+            for (const auto& entry : source) {
+                destination[offsets[(entry.key >> shift) & 0xFF]++] = entry;
+            }
+            std::swap(source, destination);
+            resultIsInScratchBuffer = !resultIsInScratchBuffer;
+        }
+        if (resultIsInScratchBuffer) {
+            std::swap(mSortEntries, mSortScratchBuffer);
+        }
+    }
+
     void Renderer::flushCommandBuffer() noexcept {
         SCOPED_TIMER();
-        if (mCommandIterator == mCommandBuffer.begin()) {
+        const auto numCommands = static_cast<std::size_t>(mCommandIterator - mCommandBuffer.begin());
+        if (numCommands == 0) {
             return;
         }
         {
             SCOPED_TIMER_NAMED("Sorting");
-            std::sort(mCommandBuffer.begin(), mCommandIterator, [](const RenderCommand& lhs, const RenderCommand& rhs) {
-                // TODO: sort differently for transparent shaders
-                return std::tie(lhs.shader->mName, lhs.texture->mName) <
-                       std::tie(rhs.shader->mName, rhs.texture->mName);
-            });
-        }
-        auto currentStartIt = mCommandBuffer.begin();
-        auto currentEndIt = std::upper_bound(mCommandBuffer.begin(), mCommandIterator, mCommandBuffer.front(),
-                                             [](const RenderCommand& lhs, const RenderCommand& rhs) {
-                                                 return lhs.shader->mName < rhs.shader->mName;
-                                             });
-
-        while (currentStartIt != mCommandIterator) {// one iteration per shader
-            mVertexIterator = mVertexData.begin();
-            mIndexIterator = mIndexData.begin();
-            mCurrentTextureNames.clear();
-            currentStartIt->shader->bind();
-            currentStartIt->shader->setUniform(Hash::staticHashString("projectionMatrix"),
-                                               mCurrentViewProjectionMatrix);
-            {
-                SCOPED_TIMER_NAMED("commands to data");
-                std::for_each(currentStartIt, currentEndIt, [&](const RenderCommand& renderCommand) {
-                    addVertexAndIndexDataFromRenderCommand(renderCommand);
-                });
+            // commands usually arrive presorted (see Application::renderDynamicSprites)
+            if (!std::is_sorted(mSortEntries.cbegin(), mSortEntries.cbegin() + static_cast<std::ptrdiff_t>(numCommands),
+                                [](const SortEntry& lhs, const SortEntry& rhs) { return lhs.key < rhs.key; })) {
+                sortCommands(numCommands);
             }
+        }
+        const auto commandAt = [&](std::size_t sortedIndex) -> const RenderCommand& {
+            return mCommandBuffer[mSortEntries[sortedIndex].commandIndex];
+        };
 
-            currentStartIt = currentEndIt;
-            if (currentEndIt != mCommandBuffer.end()) {// there's at least one more shader to draw with
-                currentEndIt = std::upper_bound(currentEndIt, mCommandIterator, *currentEndIt,
-                                                [](const RenderCommand& lhs, const RenderCommand& rhs) {
-                                                    return lhs.shader->mName < rhs.shader->mName;
-                                                });
+        std::size_t currentIndex = 0;
+        while (currentIndex < numCommands) {// one iteration per run of commands using the same shader
+            assert(mQuads.empty() && mInstanceIterator == mInstanceData.begin() && mCurrentTextureNames.empty());
+            auto& shader = *commandAt(currentIndex).shader;
+            mBackend->bindShaderProgram(shader);
+            mBackend->setUniform(shader, Hash::staticHashString("projectionMatrix"), mCurrentViewProjectionMatrix);
+            {
+                SCOPED_TIMER_NAMED("commands to data");
+                for (; currentIndex < numCommands && commandAt(currentIndex).shader->mName == shader.mName;
+                     ++currentIndex) {
+                    if (mMode == Mode::Instanced) {
+                        addInstanceDataFromRenderCommand(commandAt(currentIndex));
+                    } else {
+                        addQuadFromRenderCommand(commandAt(currentIndex));
+                    }
+                }
             }
-            flushVertexAndIndexData();
+            flushBatch();
         }
         mCommandIterator = mCommandBuffer.begin();
     }
 
-    void Renderer::flushVertexAndIndexData() noexcept {
-        if (mVertexIterator == mVertexData.begin()) {
+    void Renderer::flushBatch() noexcept {
+        const auto numInstances = static_cast<std::size_t>(mInstanceIterator - mInstanceData.begin());
+        if (mQuads.empty() && numInstances == 0) {
             return;
         }
-        mVertexBuffer.bind();
         // flush all buffers
         {
             SCOPED_TIMER_NAMED("submit data");
-            mVertexBuffer.submitVertexData(mVertexData.begin(), mVertexIterator);
-            mVertexBuffer.submitIndexData(mIndexData.begin(), mIndexIterator);
+            if (mMode == Mode::Instanced) {
+                mBackend->submitInstanceData(std::as_bytes(std::span{ mInstanceData.begin(), mInstanceIterator }));
+            } else {
+                const auto vertices = std::span{ mVertexData.data(), mQuads.size() * 4 };
+                {
+                    SCOPED_TIMER_NAMED("quads to vertices");
+                    generateQuadVertices(mQuads, vertices);
+                }
+                mBackend->submitVertexData(std::as_bytes(vertices));
+                mBackend->submitIndexData(std::as_bytes(std::span{ mIndexData.data(), mQuads.size() * 2 }),
+                                          GL_UNSIGNED_SHORT);
+            }
         }
         for (std::size_t i = 0; i < mCurrentTextureNames.size(); ++i) {
-            Texture::bind(mCurrentTextureNames[i], gsl::narrow_cast<GLint>(i));
+            mBackend->bindTexture(mCurrentTextureNames[i], gsl::narrow_cast<GLint>(i));
+        }
+        if (mMode == Mode::Instanced) {
+            mBackend->drawInstancedQuads(numInstances);
+        } else {
+            mBackend->drawIndexed();
+        }
+        mQuads.clear();
+        mInstanceIterator = mInstanceData.begin();
+        for (const auto textureName : mCurrentTextureNames) {
+            mTextureSlotLookup[textureName] = 0;
         }
-        glDrawElements(GL_TRIANGLES, gsl::narrow_cast<GLsizei>(mVertexBuffer.indicesCount()), GL_UNSIGNED_INT, nullptr);
-        mVertexIterator = mVertexData.begin();
-        mIndexIterator = mIndexData.begin();
         mCurrentTextureNames.clear();
         mNumTrianglesInCurrentBatch = 0ULL;
         mRenderStats.numBatches += 1ULL;
     }
 
-    void Renderer::addVertexAndIndexDataFromRenderCommand(const Renderer::RenderCommand& renderCommand) {
-        // TODO: use an indirection vector to optimize this as soon as there is a global asset manager
-        GLuint textureIndex = 0;
-        bool foundTexture = false;
-
-        for (std::size_t i = 0; i < mCurrentTextureNames.size(); ++i) {
-            if (mCurrentTextureNames[i] == renderCommand.texture->mName) {
-                textureIndex = gsl::narrow_cast<GLuint>(i);
-                foundTexture = true;
-                break;
-            }
+    GLuint Renderer::textureIndexInCurrentBatch(GLuint textureName) noexcept {
+        if (textureName >= mTextureSlotLookup.size()) {
+            mTextureSlotLookup.resize(std::size_t{ textureName } + 1, 0);
         }
-
-        if ((!foundTexture && mCurrentTextureNames.size() == mCurrentTextureNames.capacity()) ||
-            (mVertexData.end() - mVertexIterator) < 4) {
-            flushVertexAndIndexData();
+        if (mTextureSlotLookup[textureName] != 0) {
+            return GLuint{ mTextureSlotLookup[textureName] } - 1;
         }
-        if (!foundTexture) {
-            textureIndex = static_cast<GLuint>(mCurrentTextureNames.size());
-            mCurrentTextureNames.push_back(renderCommand.texture->mName);
+        if (mCurrentTextureNames.size() == mCurrentTextureNames.capacity()) {
+            flushBatch();
         }
+        mCurrentTextureNames.push_back(textureName);
+        mTextureSlotLookup[textureName] = gsl::narrow_cast<std::uint8_t>(mCurrentTextureNames.size());
+        return gsl::narrow_cast<GLuint>(mCurrentTextureNames.size() - 1);
+    }
 
-        const auto indexOffset = gsl::narrow_cast<GLuint>(mVertexIterator - mVertexData.begin());
-        constexpr std::array<glm::vec4, 4> positions{ glm::vec4{ -1.0f, -1.0f, 0.0f, 1.0f },
-                                                      glm::vec4{ 1.0f, -1.0f, 0.0f, 1.0f },
-                                                      glm::vec4{ 1.0f, 1.0f, 0.0f, 1.0f },
-                                                      glm::vec4{ -1.0f, 1.0f, 0.0f, 1.0f } };
-        const std::array<glm::vec2, 4> texCoords{
-            glm::vec2{ renderCommand.textureRect.left, renderCommand.textureRect.bottom },
-            glm::vec2{ renderCommand.textureRect.right, renderCommand.textureRect.bottom },
-            glm::vec2{ renderCommand.textureRect.right, renderCommand.textureRect.top },
-            glm::vec2{ renderCommand.textureRect.left, renderCommand.textureRect.top }
-        };
-        for (std::size_t i = 0; i < 4; ++i) {
-            mVertexIterator->position = renderCommand.transformMatrix * positions[i];
-            mVertexIterator->color = renderCommand.color;
-            mVertexIterator->texCoords = texCoords[i];
-            mVertexIterator->texIndex = textureIndex;
-            ++mVertexIterator;
-        }
-        for (GLuint i = 1; i <= 2; ++i) {
-            mIndexIterator->i0 = indexOffset;
-            mIndexIterator->i1 = indexOffset + i;
-            mIndexIterator->i2 = indexOffset + i + 1;
-            ++mIndexIterator;
+    void Renderer::addQuadFromRenderCommand(const Renderer::RenderCommand& renderCommand) {
+        if (mQuads.size() == mQuads.capacity()) {
+            flushBatch();
+        }
+        const auto textureIndex = textureIndexInCurrentBatch(renderCommand.texture->mName);
+        mQuads.add(renderCommand.transformMatrix, renderCommand.textureRect, glm::packUnorm4x8(renderCommand.color),
+                   gsl::narrow_cast<GLushort>(textureIndex));
+        mNumTrianglesInCurrentBatch += 2ULL;
+        mRenderStats.numVertices += 4ULL;
+        mRenderStats.numTriangles += 2ULL;
+    }
+
+    void Renderer::addInstanceDataFromRenderCommand(const Renderer::RenderCommand& renderCommand) {
+        if (mInstanceIterator == mInstanceData.end()) {
+            flushBatch();
         }
+        const auto textureIndex = textureIndexInCurrentBatch(renderCommand.texture->mName);
+        const auto& transform = renderCommand.transformMatrix;
+        *mInstanceIterator++ = InstanceData{ .transformedX{ glm::vec2{ transform[0] } },
+                                             .transformedY{ glm::vec2{ transform[1] } },
+                                             .translation{ glm::vec3{ transform[3] } },
+                                             .textureRect{ renderCommand.textureRect },
+                                             .color{ glm::packUnorm4x8(renderCommand.color) },
+                                             .texIndex{ textureIndex } };
         mNumTrianglesInCurrentBatch += 2ULL;
         mRenderStats.numVertices += 4ULL;
         mRenderStats.numTriangles += 2ULL;
@@ -4,12 +4,16 @@
 
 #pragma once
 
-#include "VertexBuffer.hpp"
+#include "RenderBackend.hpp"
+#include "QuadVertexKernel.hpp"
 #include "ShaderProgram.hpp"
 #include "Texture.hpp"
 #include "Color.hpp"
 #include "Window.hpp"
 #include "Rect.hpp"
+#include "WindowSize.hpp"
+#include <memory>
+#include <tuple>
 
 namespace c2k {
 
@@ -21,27 +25,48 @@ namespace c2k {
 
     class Renderer final {
     public:
-        struct VertexData {
-            glm::vec3 position;
-            glm::vec4 color;
-            glm::vec2 texCoords;
-            GLuint texIndex;
-        };
+        using VertexData = QuadVertex;
         static_assert(alignof(VertexData) == 4);
         static_assert(sizeof(VertexData[2]) == 2 * sizeof(VertexData));
-        static_assert(sizeof(VertexData) == 10 * sizeof(GLfloat));
+        static_assert(sizeof(VertexData) == 6 * sizeof(GLfloat));
 
+        /* Batches never exceed maxVerticesPerBatch vertices, so 16 bit indices suffice. Since every batch consists
+         * of quads, the index data never changes and is only generated once. */
         struct IndexData {
-            GLuint i0, i1, i2;
+            GLushort i0, i1, i2;
         };
-        static_assert(alignof(IndexData) == 4);
-        static_assert(sizeof(IndexData) == 3 * sizeof(GLuint));
+        static_assert(alignof(IndexData) == 2);
+        static_assert(sizeof(IndexData) == 3 * sizeof(GLushort));
         static_assert(sizeof(IndexData[2]) == 2 * sizeof(IndexData));
 
+        // per quad data of the instanced mode, the vertex shader expands it into the corners (see instanced.vert)
+        struct InstanceData {
+            glm::vec2 transformedX;// first two columns of the 2D affine transform
+            glm::vec2 transformedY;
+            glm::vec3 translation;
+            Rect textureRect;
+            GLuint color;// RGBA8
+            GLuint texIndex;
+        };
+        static_assert(alignof(InstanceData) == 4);
+        static_assert(sizeof(InstanceData) == 13 * sizeof(GLfloat));
+
+        enum class Mode {
+            Batched,  // the corners of all quads are calculated on the CPU
+            Instanced,// one InstanceData per quad is uploaded, needs a vertex shader like instanced.vert
+        };
+
+        // quads are drawn layer by layer, starting with layer 0
+        using Layer = std::uint8_t;
+
     public:
-        Renderer(const Window& window);
+        // renders into the given window using OpenGL
+        Renderer(const Window& window, Mode mode = Mode::Batched);
+        // does not need a window, but beginFrame() has to be given the framebuffer size
+        explicit Renderer(std::unique_ptr<RenderBackend> backend, Mode mode = Mode::Batched);
 
         void beginFrame(const glm::mat4& viewMatrix) noexcept;
+        void beginFrame(const glm::mat4& viewMatrix, const WindowSize& framebufferSize) noexcept;
         void endFrame() noexcept;
         void drawQuad(const glm::vec3& translation,
                       float rotationAngle,
@@ -49,12 +74,27 @@ namespace c2k {
                       ShaderProgram& shader,
                       const Texture& texture,
                       const Rect& textureRect = Rect::unit(),
-                      const Color& color = Color::white()) noexcept;
+                      const Color& color = Color::white(),
+                      Layer layer = 0) noexcept;
         void drawQuad(const glm::mat4& transformMatrix,
                       ShaderProgram& shader,
                       const Texture& texture,
                       const Rect& textureRect = Rect::unit(),
-                      const Color& color = Color::white()) noexcept;
+                      const Color& color = Color::white(),
+                      Layer layer = 0) noexcept;
+
+        /* The order in which the renderer batches quads of the same layer. Submitting opaque quads in this order
+         * lets the renderer skip sorting them. Translucent quads are additionally sorted back to front. */
+        [[nodiscard]] static bool isDrawnBefore(const ShaderProgram& lhsShader,
+                                                const Texture& lhsTexture,
+                                                const Color& lhsColor,
+                                                const ShaderProgram& rhsShader,
+                                                const Texture& rhsTexture,
+                                                const Color& rhsColor) noexcept {
+            return std::tuple{ isTranslucent(lhsColor), lhsShader.mName, lhsTexture.mName } <
+                   std::tuple{ isTranslucent(rhsColor), rhsShader.mName, rhsTexture.mName };
+        }
+
         [[nodiscard]] const RenderStats& stats() const {
             return mRenderStats;
         }
@@ -70,26 +110,54 @@ namespace c2k {
             const Texture* texture;
         };
 
+        /* Bits 56-63: layer, bit 55: translucency, bits 32-54: depth (translucent quads only), bits 16-31: shader
+         * program name, bits 0-15: texture name. Sorting by the key sorts the commands into the drawing order. */
+        struct SortEntry {
+            std::uint64_t key;
+            std::uint32_t commandIndex;
+        };
+
     private:
+        [[nodiscard]] static constexpr bool isTranslucent(const Color& color) noexcept {
+            return color.a < 1.0f;
+        }
+        [[nodiscard]] static std::uint64_t sortKey(Layer layer,
+                                                   bool translucent,
+                                                   float clipSpaceDepth,
+                                                   const ShaderProgram& shader,
+                                                   const Texture& texture) noexcept;
+        void sortCommands(std::size_t numCommands) noexcept;
         void flushCommandBuffer() noexcept;
-        void flushVertexAndIndexData() noexcept;
-        void addVertexAndIndexDataFromRenderCommand(const RenderCommand& renderCommand);
+        void flushBatch() noexcept;
+        [[nodiscard]] GLuint textureIndexInCurrentBatch(GLuint textureName) noexcept;
+        void addQuadFromRenderCommand(const RenderCommand& renderCommand);
+        void addInstanceDataFromRenderCommand(const RenderCommand& renderCommand);
 
     private:
         static constexpr std::size_t maxCommandsPerBatch = 20'000;
+        static constexpr std::size_t maxVerticesPerBatch = std::size_t{ std::numeric_limits<GLushort>::max() } + 1;
+        static constexpr std::size_t maxIndexDataPerBatch = maxVerticesPerBatch / 4 * 2;
+        static constexpr std::size_t maxInstancesPerBatch = 100'000;
+        static constexpr std::size_t maxTextureSlots = 32;
+        static_assert(maxTextureSlots < std::numeric_limits<std::uint8_t>::max());
+        Mode mMode;
         std::uint64_t mNumTrianglesInCurrentBatch = 0ULL;
         std::vector<RenderCommand> mCommandBuffer;
+        std::vector<SortEntry> mSortEntries;// one per command
+        std::vector<SortEntry> mSortScratchBuffer;
+        QuadBatch mQuads;
         std::vector<VertexData> mVertexData;
         std::vector<IndexData> mIndexData;
+        std::vector<InstanceData> mInstanceData;
         decltype(mCommandBuffer)::iterator mCommandIterator;
-        decltype(mVertexData)::iterator mVertexIterator;
-        decltype(mIndexData)::iterator mIndexIterator;
-        VertexBuffer mVertexBuffer;
+        decltype(mInstanceData)::iterator mInstanceIterator;
+        std::unique_ptr<RenderBackend> mBackend;
         RenderStats mRenderStats;
         std::vector<GLuint> mCurrentTextureNames;
+        std::vector<std::uint8_t> mTextureSlotLookup;// indexed by texture name, 0 or slot + 1
         GLuint mCurrentShaderProgramName{ 0U };
         glm::mat4 mCurrentViewProjectionMatrix{ 0.0f };
-        const Window& mWindow;
+        const Window* mWindow{ nullptr };
     };
 
 }// namespace c2k
\ No newline at end of file
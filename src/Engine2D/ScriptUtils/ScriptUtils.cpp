@@ -7,6 +7,7 @@
 #include "../Registry.hpp"
 #include "../AssetDatabase.hpp"
 #include "../Application.hpp"
+#include "../CommandBuffer.hpp"
 #define MAGIC_ENUM_RANGE_MAX 348
 #include <magic_enum.hpp>
 
@@ -255,8 +256,7 @@ namespace c2k::ScriptUtils {
             inline void provideDestructionAPI(ApplicationContext& applicationContext,
                                               sol::usertype<LuaEntity>& entityType) noexcept {
                 entityType["destroy"] = [&](LuaEntity& luaEntity) {
-                    applicationContext.bufferedScriptCommands.emplace_back(
-                            BufferedScriptCommands::DestroyEntity{ .targetEntity{ luaEntity } });
+                    applicationContext.commandBuffers.local().destroyEntity(luaEntity);
                     luaEntity = invalidEntity;
                 };
             }
@@ -286,9 +286,9 @@ namespace c2k::ScriptUtils {
             inline void provideScriptAPI(ApplicationContext& applicationContext,
                                          sol::usertype<LuaEntity>& entityType) noexcept {
                 entityType["attachScript"] = [&](LuaEntity luaEntity, const LuaScript& luaScript) {
-                    applicationContext.bufferedScriptCommands.emplace_back(
-                            BufferedScriptCommands::AttachScript{ .scriptGUID{ GUID::fromString(luaScript.guid) },
-                                                                  .targetEntity{ luaEntity } });
+                    auto& script = applicationContext.assetDatabase.scriptMutable(GUID::fromString(luaScript.guid));
+                    applicationContext.commandBuffers.local().attachComponent(
+                            Entity{ luaEntity }, ScriptComponent{ .script{ &script } });
                 };
             }
 
@@ -25,7 +25,9 @@ namespace c2k {
     }
 
     ShaderProgram::~ShaderProgram() {
-        glDeleteProgram(mName);
+        if (hasBeenCompiled()) {
+            glDeleteProgram(mName);
+        }
     }
 
     bool ShaderProgram::compile(const std::string& vertexShaderSource,
@@ -49,6 +49,7 @@ namespace c2k {
         std::unordered_map<std::size_t, GLint> mUniformLocations;
 
         friend class Renderer;
+        friend class RecordingRenderBackend;
     };
 
 }// namespace c2k
\ No newline at end of file
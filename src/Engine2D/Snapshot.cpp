@@ -0,0 +1,64 @@
+//
+// Created by coder2k on 08.12.2021.
+//
+
+#include "Snapshot.hpp"
+#include <spdlog/spdlog.h>
+
+namespace c2k {
+
+    std::uint64_t SnapshotWriter::assetIndex(const void* asset, GUID guid) noexcept {
+        const auto [iterator, inserted] = mAssetIndices.try_emplace(asset, mAssetTable.size());
+        if (inserted) {
+            mAssetTable.push_back(AssetEntry{ .guid{ guid }, .address{ asset } });
+        }
+        return iterator->second;
+    }
+
+    std::vector<std::byte> SnapshotWriter::finish() noexcept {
+        // the asset table is stored at the end, followed by the number of its entries
+        for (const auto& entry : mAssetTable) {
+            write(entry.guid);
+            write(reinterpret_cast<std::uintptr_t>(entry.address));
+        }
+        write(static_cast<std::uint64_t>(mAssetTable.size()));
+        mAssetTable.clear();
+        mAssetIndices.clear();
+        return std::move(mData);
+    }
+
+    SnapshotReader::SnapshotReader(std::span<const std::byte> snapshot, const AssetResolver& resolveAsset) noexcept
+        : mHasAssetResolver{ static_cast<bool>(resolveAsset) } {
+        constexpr auto entrySize = sizeof(GUID) + sizeof(std::uintptr_t);
+        if (snapshot.size() < sizeof(std::uint64_t)) {
+            return;
+        }
+        std::uint64_t numAssets;
+        std::memcpy(&numAssets, snapshot.data() + snapshot.size() - sizeof(numAssets), sizeof(numAssets));
+        if (numAssets > (snapshot.size() - sizeof(numAssets)) / entrySize) {
+            return;
+        }
+        mIsValid = true;
+        const auto payloadSize = snapshot.size() - sizeof(numAssets) - numAssets * entrySize;
+        mPayload = snapshot.first(payloadSize);
+        mAssets.reserve(numAssets);
+        for (std::uint64_t i = 0; i < numAssets; ++i) {
+            const auto entry = snapshot.data() + payloadSize + i * entrySize;
+            GUID guid;
+            std::uintptr_t address;
+            std::memcpy(&guid, entry, sizeof(guid));
+            std::memcpy(&address, entry + sizeof(guid), sizeof(address));
+            if (!resolveAsset) {
+                mAssets.push_back(reinterpret_cast<void*>(address));
+                continue;
+            }
+            const auto asset = resolveAsset(guid);
+            if (asset == nullptr) {
+                spdlog::error("Unable to resolve asset with GUID {} while restoring a snapshot.", guid);
+                mHasResolvedAllAssets = false;
+            }
+            mAssets.push_back(asset);
+        }
+    }
+
+}// namespace c2k
\ No newline at end of file
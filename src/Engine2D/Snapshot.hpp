@@ -0,0 +1,222 @@
+//
+// Created by coder2k on 08.12.2021.
+//
+
+#pragma once
+
+#include "GUID.hpp"
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <span>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace c2k {
+
+    // returns the address of the asset with the given GUID (or nullptr if it does not exist)
+    using AssetResolver = std::function<void*(GUID guid)>;
+
+    struct NoAssetReferences { };
+
+    /* Specialize this for components that hold pointers to assets. forEach(component, function) has to call
+     * function with a reference to every asset pointer of the component. Snapshots store those pointers as
+     * GUIDs, so the asset types need a guid member. */
+    template<typename Component>
+    struct AssetReferences : NoAssetReferences { };
+
+    template<typename Component>
+    concept HasAssetReferences = !std::is_base_of_v<NoAssetReferences, AssetReferences<Component>>;
+
+    /* Specialize this as std::true_type for components that hold pointers to objects without GUIDs. Those
+     * pointers are copied as they are, so restoring such components with an asset resolver fails. */
+    template<typename Component>
+    struct HasProcessLocalPointers : std::false_type { };
+
+    // appends binary data to a snapshot and collects the referenced assets
+    class SnapshotWriter final {
+    public:
+        void writeBytes(const void* data, std::size_t numBytes) noexcept {
+            const auto offset = mData.size();
+            mData.resize(offset + numBytes);
+            if (numBytes > 0) {
+                std::memcpy(mData.data() + offset, data, numBytes);
+            }
+        }
+
+        template<typename T>
+        requires std::is_trivially_copyable_v<T> void write(const T& value) noexcept {
+            writeBytes(&value, sizeof(T));
+        }
+
+        // index of the given asset within the asset table of the snapshot
+        [[nodiscard]] std::uint64_t assetIndex(const void* asset, GUID guid) noexcept;
+
+        // appends the asset table and returns the finished snapshot
+        [[nodiscard]] std::vector<std::byte> finish() noexcept;
+
+    private:
+        struct AssetEntry {
+            GUID guid;
+            const void* address;
+        };
+
+    private:
+        std::vector<std::byte> mData;
+        std::vector<AssetEntry> mAssetTable;
+        std::unordered_map<const void*, std::uint64_t> mAssetIndices;
+    };
+
+    /* Reads the data of a snapshot in the order it has been written. If no asset resolver is given, the assets
+     * are expected to still live at the same addresses as when the snapshot was taken (e.g. when rewinding or
+     * forking a simulation within the same process). The snapshot may come from anywhere, so everything has to
+     * be validated via tryRead() and numRemainingBytes() before using the asserting functions. */
+    class SnapshotReader final {
+    public:
+        SnapshotReader(std::span<const std::byte> snapshot, const AssetResolver& resolveAsset) noexcept;
+
+        // false if the snapshot is too short to even contain its asset table
+        [[nodiscard]] bool isValid() const noexcept {
+            return mIsValid;
+        }
+
+        [[nodiscard]] bool hasAssetResolver() const noexcept {
+            return mHasAssetResolver;
+        }
+
+        // false if the asset resolver returned nullptr for at least one entry of the asset table
+        [[nodiscard]] bool hasResolvedAllAssets() const noexcept {
+            return mHasResolvedAllAssets;
+        }
+
+        [[nodiscard]] std::size_t numAssets() const noexcept {
+            return mAssets.size();
+        }
+
+        [[nodiscard]] std::size_t numRemainingBytes() const noexcept {
+            return mPayload.size() - mPosition;
+        }
+
+        // returns a pointer to the next numBytes bytes of the snapshot and skips them
+        [[nodiscard]] const std::byte* consume(std::size_t numBytes) noexcept {
+            assert(mPosition + numBytes <= mPayload.size() && "Snapshot is too short.");
+            const auto result = mPayload.data() + mPosition;
+            mPosition += numBytes;
+            return result;
+        }
+
+        void readBytes(void* destination, std::size_t numBytes) noexcept {
+            if (numBytes > 0) {
+                std::memcpy(destination, consume(numBytes), numBytes);
+            }
+        }
+
+        template<typename T>
+        requires std::is_trivially_copyable_v<T>
+        [[nodiscard]] T read() noexcept {
+            T result;
+            readBytes(&result, sizeof(T));
+            return result;
+        }
+
+        // returns false (without reading anything) if the snapshot is too short
+        template<typename T>
+        requires std::is_trivially_copyable_v<T>
+        [[nodiscard]] bool tryRead(T& result) noexcept {
+            if (numRemainingBytes() < sizeof(T)) {
+                return false;
+            }
+            result = read<T>();
+            return true;
+        }
+
+        // the asset indices are checked while validating the snapshot (see SnapshotOperations)
+        [[nodiscard]] void* asset(std::uint64_t assetIndex) const noexcept {
+            assert(assetIndex < mAssets.size() && "Invalid asset index.");
+            return mAssets[static_cast<std::size_t>(assetIndex)];
+        }
+
+    private:
+        std::span<const std::byte> mPayload;
+        std::size_t mPosition{ 0 };
+        std::vector<void*> mAssets;
+        bool mIsValid{ false };
+        bool mHasAssetResolver{ false };
+        bool mHasResolvedAllAssets{ true };
+    };
+
+    // how the elements of a component storage get written into and restored from snapshots
+    struct SnapshotOperations {
+        void (*write)(const void* elements, std::size_t count, SnapshotWriter& writer);
+        // the elements have been copied bytewise from the snapshot, so asset pointers hold asset indices
+        void (*resolveAssets)(void* elements, std::size_t count, const SnapshotReader& reader);
+        // false if an asset pointer of the (bytewise copied, possibly unaligned) elements isn't a valid asset index
+        bool (*hasValidAssetIndices)(const std::byte* elements, std::size_t count, std::size_t numAssets);
+        bool hasProcessLocalPointers;// see HasProcessLocalPointers
+    };
+
+    // nullptr for components that can't be part of a snapshot (because they are not trivially copyable)
+    template<typename Component>
+    [[nodiscard]] const SnapshotOperations* snapshotOperationsFor() noexcept {
+        if constexpr (!std::is_trivially_copyable_v<Component>) {
+            return nullptr;
+        } else if constexpr (!HasAssetReferences<Component>) {
+            static constexpr SnapshotOperations operations{
+                .write{ [](const void* elements, std::size_t count, SnapshotWriter& writer) {
+                    writer.writeBytes(elements, count * sizeof(Component));
+                } },
+                .resolveAssets{ nullptr },
+                .hasValidAssetIndices{ nullptr },
+                .hasProcessLocalPointers{ HasProcessLocalPointers<Component>::value },
+            };
+            return &operations;
+        } else {
+            static constexpr SnapshotOperations operations{
+                .write{ [](const void* elements, std::size_t count, SnapshotWriter& writer) {
+                    for (std::size_t i = 0; i < count; ++i) {
+                        auto copy = static_cast<const Component*>(elements)[i];
+                        AssetReferences<Component>::forEach(copy, [&writer](auto& pointer) {
+                            using Pointer = std::remove_reference_t<decltype(pointer)>;
+                            const auto index = (pointer == nullptr ? std::numeric_limits<std::uint64_t>::max()
+                                                                   : writer.assetIndex(pointer, pointer->guid));
+                            pointer = reinterpret_cast<Pointer>(static_cast<std::uintptr_t>(index));
+                        });
+                        writer.write(copy);
+                    }
+                } },
+                .resolveAssets{ [](void* elements, std::size_t count, const SnapshotReader& reader) {
+                    for (std::size_t i = 0; i < count; ++i) {
+                        auto& element = static_cast<Component*>(elements)[i];
+                        AssetReferences<Component>::forEach(element, [&reader](auto& pointer) {
+                            using Pointer = std::remove_reference_t<decltype(pointer)>;
+                            const auto index = static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(pointer));
+                            pointer = (index == std::numeric_limits<std::uint64_t>::max()
+                                               ? nullptr
+                                               : static_cast<Pointer>(reader.asset(index)));
+                        });
+                    }
+                } },
+                .hasValidAssetIndices{ [](const std::byte* elements, std::size_t count, std::size_t numAssets) {
+                    bool isValid{ true };
+                    for (std::size_t i = 0; i < count; ++i) {
+                        Component element;
+                        std::memcpy(&element, elements + i * sizeof(Component), sizeof(Component));
+                        AssetReferences<Component>::forEach(element, [&isValid, numAssets](auto& pointer) {
+                            const auto index = static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(pointer));
+                            isValid = isValid && (index == std::numeric_limits<std::uint64_t>::max() ||
+                                                  index < numAssets);
+                        });
+                    }
+                    return isValid;
+                } },
+                .hasProcessLocalPointers{ HasProcessLocalPointers<Component>::value },
+            };
+            return &operations;
+        }
+    }
+
+}// namespace c2k
\ No newline at end of file
@@ -5,17 +5,227 @@
 
 namespace c2k {
 
-    void SparseSet::remove(Entity index) noexcept {
+    void SparseSet::remove(Index index) noexcept {
         using std::swap;
         assert(has(index) && "The given index doesn't have an instance of this element.");
-        const auto denseIndex = mSparseVector[index];
-        mSparseVector[mDenseVector.back()] = denseIndex;
-        mSparseVector[index] = invalidEntity;
+        const auto denseIndex = sparseEntry(index);
+        sparseEntry(mDenseVector.back()) = denseIndex;
+        sparseEntry(index) = invalidDenseIndex;
         mDenseVector[denseIndex] = mDenseVector.back();
         mDenseVector.pop_back();
-        mElementVector.swapElements(denseIndex, mElementVector.size() - 1);
-        mElementVector.pop_back();
-        assert(mDenseVector.size() == mElementVector.size());
+        if (isStructOfArrays()) {
+            for (auto& column : mColumns) {
+                column.swapRemove(denseIndex);
+            }
+        } else {
+            mElementVector.swapRemove(denseIndex);
+            assert(mDenseVector.size() == mElementVector.size());
+        }
+    }
+
+    void SparseSet::removeMany(std::span<const Index> indices) noexcept {
+        // swap removals only touch the removed elements, compacting touches all of them
+        if (indices.size() * 4 < mDenseVector.size()) {
+            for (const auto index : indices) {
+                remove(index);
+            }
+            return;
+        }
+        for (const auto index : indices) {
+            assert(has(index) && "The given index doesn't have an instance of this element.");
+            sparseEntry(index) = invalidDenseIndex;
+        }
+        // the remaining elements keep their relative order, so owning groups stay packed at the front
+        std::size_t numRemaining{ 0 };
+        for (std::size_t denseIndex = 0; denseIndex < mDenseVector.size(); ++denseIndex) {
+            const auto index = mDenseVector[denseIndex];
+            if (sparseEntry(index) == invalidDenseIndex) {
+                continue;
+            }
+            if (denseIndex != numRemaining) {
+                mDenseVector[numRemaining] = index;
+                if (isStructOfArrays()) {
+                    for (auto& column : mColumns) {
+                        column.swapElements(numRemaining, denseIndex);
+                    }
+                } else {
+                    mElementVector.swapElements(numRemaining, denseIndex);
+                }
+            }
+            sparseEntry(index) = static_cast<DenseIndex>(numRemaining);
+            ++numRemaining;
+        }
+        mDenseVector.resize(numRemaining);
+        if (isStructOfArrays()) {
+            for (auto& column : mColumns) {
+                column.resize(numRemaining);
+            }
+        } else {
+            mElementVector.resize(numRemaining);
+        }
+    }
+
+    void SparseSet::clear() noexcept {
+        for (const auto& page : mSparsePages) {
+            if (page != nullptr) {
+                std::fill_n(page.get(), sparsePageSize, invalidDenseIndex);
+            }
+        }
+        mDenseVector.clear();
+        mElementVector.resize(0);
+        for (auto& column : mColumns) {
+            column.resize(0);
+        }
+    }
+
+    void SparseSet::writeSnapshot(SnapshotWriter& writer) const noexcept {
+        assert((mSnapshotOperations != nullptr || mDenseVector.empty()) &&
+               "Only trivially copyable components can be part of a snapshot.");
+        writer.write(static_cast<std::uint64_t>(mElementVector.elementSizePadded()));
+        writer.write(static_cast<std::uint64_t>(mDenseVector.size()));
+        writer.writeBytes(mDenseVector.data(), mDenseVector.size() * sizeof(Index));
+        if (mDenseVector.empty() || isTagStorage()) {
+            return;
+        }
+        if (isStructOfArrays()) {
+            mStructOfArraysOperations->writeSnapshot(mColumns, *mSnapshotOperations, writer);
+        } else {
+            mSnapshotOperations->write(mElementVector.data(), mElementVector.size(), writer);
+        }
+    }
+
+    bool SparseSet::validateSnapshot(SnapshotReader& reader,
+                                     const std::vector<bool>& validIndices,
+                                     std::size_t& count,
+                                     const std::byte*& elements) const noexcept {
+        std::uint64_t elementSize;
+        std::uint64_t numElements;
+        if (!reader.tryRead(elementSize) || !reader.tryRead(numElements)) {
+            spdlog::error("Snapshot is truncated.");
+            return false;
+        }
+        if (elementSize != mElementVector.elementSizePadded()) {
+            spdlog::error("Element size {} within snapshot does not match the component type.", elementSize);
+            return false;
+        }
+        if (numElements == 0) {
+            count = 0;
+            elements = nullptr;
+            return true;
+        }
+        if (mSnapshotOperations == nullptr) {
+            spdlog::error("Snapshot contains a component type that can't be part of a snapshot.");
+            return false;
+        }
+        if (mSnapshotOperations->hasProcessLocalPointers && reader.hasAssetResolver()) {
+            spdlog::error("Snapshot contains components with pointers that can't be resolved by GUID.");
+            return false;
+        }
+        // every index is used at most once, so there can't be more elements than indices
+        if (numElements > validIndices.size() ||
+            numElements * (sizeof(Index) + mElementVector.elementSizePadded()) > reader.numRemainingBytes()) {
+            spdlog::error("Snapshot is truncated.");
+            return false;
+        }
+        count = static_cast<std::size_t>(numElements);
+        const auto indices = reader.consume(count * sizeof(Index));
+        std::vector<bool> isUsed(validIndices.size(), false);
+        for (std::size_t i = 0; i < count; ++i) {
+            Index index;
+            std::memcpy(&index, indices + i * sizeof(Index), sizeof(Index));
+            if (index >= validIndices.size() || !validIndices[index] || isUsed[index]) {
+                spdlog::error("Snapshot contains an invalid or duplicate sparse index {}.", index);
+                return false;
+            }
+            isUsed[index] = true;
+        }
+        elements = reader.consume(count * mElementVector.elementSizePadded());
+        if (mSnapshotOperations->hasValidAssetIndices != nullptr &&
+            !mSnapshotOperations->hasValidAssetIndices(elements, count, reader.numAssets())) {
+            spdlog::error("Snapshot contains an invalid asset index.");
+            return false;
+        }
+        return true;
+    }
+
+    void SparseSet::readSnapshot(SnapshotReader& reader) noexcept {
+        [[maybe_unused]] const auto elementSize = reader.read<std::uint64_t>();
+        assert(elementSize == mElementVector.elementSizePadded() && "Component type mismatch.");
+        const auto count = static_cast<std::size_t>(reader.read<std::uint64_t>());
+        assert((mSnapshotOperations != nullptr || count == 0) &&
+               "Only trivially copyable components can be part of a snapshot.");
+        clear();
+        mDenseVector.resize(count);
+        reader.readBytes(mDenseVector.data(), count * sizeof(Index));
+        const auto elements = reader.consume(count * mElementVector.elementSizePadded());
+        if (isStructOfArrays()) {
+            if (count > 0) {
+                mStructOfArraysOperations->readSnapshot(mColumns, *mSnapshotOperations, elements, count, reader);
+            }
+        } else {
+            mElementVector.assignBytes(elements, count);
+            if (count > 0 && mSnapshotOperations->resolveAssets != nullptr) {
+                mSnapshotOperations->resolveAssets(mElementVector.data(), count, reader);
+            }
+        }
+        for (std::size_t denseIndex = 0; denseIndex < count; ++denseIndex) {
+            const auto index = mDenseVector[denseIndex];
+            assert(index < mSize && "Invalid index id.");
+            allocateSparsePageIfNecessary(index);
+            sparseEntry(index) = static_cast<DenseIndex>(denseIndex);
+        }
+    }
+
+    void SparseSet::swapDenseEntries(std::size_t firstDenseIndex, std::size_t secondDenseIndex) noexcept {
+        using std::swap;
+        assert(firstDenseIndex < mDenseVector.size() && secondDenseIndex < mDenseVector.size());
+        if (firstDenseIndex == secondDenseIndex) {
+            return;
+        }
+        const auto firstIndex = mDenseVector[firstDenseIndex];
+        const auto secondIndex = mDenseVector[secondDenseIndex];
+        swap(sparseEntry(firstIndex), sparseEntry(secondIndex));
+        swap(mDenseVector[firstDenseIndex], mDenseVector[secondDenseIndex]);
+        if (isStructOfArrays()) {
+            for (auto& column : mColumns) {
+                column.swapElements(firstDenseIndex, secondDenseIndex);
+            }
+        } else {
+            mElementVector.swapElements(firstDenseIndex, secondDenseIndex);
+        }
+    }
+
+    void SparseSet::permute(std::size_t first, std::span<const std::size_t> order) noexcept {
+        assert(first + order.size() <= mDenseVector.size());
+        auto& done = mPermutedScratch;
+        done.assign(order.size(), false);
+        for (std::size_t start = 0; start < order.size(); ++start) {
+            if (done[start]) {
+                continue;
+            }
+            // walk along the cycle while carrying the entry that started at first + start
+            auto current = start;
+            while (true) {
+                done[current] = true;
+                const auto source = order[current] - first;
+                if (source == start) {
+                    break;
+                }
+                swapDenseEntries(first + current, first + source);
+                current = source;
+            }
+        }
+    }
+
+    void SparseSet::allocateSparsePageIfNecessary(Index index) noexcept {
+        const auto pageIndex = static_cast<std::size_t>(index / sparsePageSize);
+        if (pageIndex >= mSparsePages.size()) {
+            mSparsePages.resize(pageIndex + 1);
+        }
+        if (mSparsePages[pageIndex] == nullptr) {
+            mSparsePages[pageIndex] = std::make_unique_for_overwrite<DenseIndex[]>(sparsePageSize);
+            std::fill_n(mSparsePages[pageIndex].get(), sparsePageSize, invalidDenseIndex);
+        }
     }
 
 }// namespace c2k
@@ -6,26 +6,52 @@
 
 #include "TypeErasedVector.hpp"
 #include "Entity.hpp"
+#include "Snapshot.hpp"
+#include "StructOfArrays.hpp"
+#include "TypeIdentifier.hpp"
 
+#include <algorithm>
 #include <cassert>
+#include <limits>
 #include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <numeric>
 #include <range/v3/all.hpp>
+#include <span>
 #include <type_traits>
 #include <utility>
 #include <vector>
 
 namespace c2k {
 
+    enum class SortAlgorithm {
+        Standard,
+        Insertion,// almost free on nearly sorted data, e.g. when sorting every frame
+    };
+
     class SparseSet final {
+    public:
+        static constexpr std::size_t sparsePageSize = 4096;// number of entries per sparse page
+        using Index = EntityLayout::Identifier;
+        // sparse pages only store dense indices, so they stay compact even with wide entity handles
+        using DenseIndex = std::uint32_t;
+        static constexpr DenseIndex invalidDenseIndex = std::numeric_limits<DenseIndex>::max();
+
     public:
         template<typename T>
         explicit SparseSet(std::type_identity<T>,
-                           Entity initialSetSize,
-                           Entity initialElementCapacity = Entity{ 0 }) noexcept
-            : mSparseVector(initialSetSize, invalidEntity),// <- no unified initialization because of ctor ambiguity
-              mElementVector{ TypeErasedVector::forType<T>() } {
-            mDenseVector.reserve(initialElementCapacity);
-            mElementVector.reserve(initialElementCapacity);
+                           std::size_t initialSetSize,
+                           std::size_t initialElementCapacity = 0) noexcept
+            : mSize{ initialSetSize },
+              mElementVector{ TypeErasedVector::forType<T>() },
+              mSnapshotOperations{ snapshotOperationsFor<T>() },
+              mStructOfArraysOperations{ structOfArraysOperationsFor<T>() },
+              mTypeHash{ TypeIdentifier::hash<T>() } {
+            if constexpr (HasStructOfArrays<T>) {
+                mColumns = StructOfArraysImpl::createColumns<T>();
+            }
+            reserve(initialElementCapacity);
         }
 
         [[nodiscard]] auto begin() noexcept {
@@ -69,53 +95,164 @@ namespace c2k {
         }
 
         template<typename Component>
-        void add(Entity index, Component&& element) noexcept {
-            assert(index < mSparseVector.size() && "Invalid index id.");
+        void add(Index index, Component&& element) noexcept {
+            assert(index < mSize && "Invalid index id.");
             assert(!has(index));
-            mSparseVector[index] = static_cast<Entity>(mDenseVector.size());
+            allocateSparsePageIfNecessary(index);
+            assert(mDenseVector.size() < invalidDenseIndex && "Too many elements.");
+            sparseEntry(index) = static_cast<DenseIndex>(mDenseVector.size());
             mDenseVector.push_back(index);
-            mElementVector.push_back(std::forward<decltype(element)>(element));
+            if constexpr (HasStructOfArrays<std::remove_cvref_t<Component>>) {
+                StructOfArraysImpl::pushBack<std::remove_cvref_t<Component>>(mColumns, element);
+            } else {
+                mElementVector.push_back(std::forward<decltype(element)>(element));
+            }
+        }
+
+        // appends the given indices (which must not have an element yet) together with a copy of element each
+        template<typename Component>
+        void addMany(std::span<const Index> indices, const Component& element) noexcept {
+            assert(mDenseVector.size() + indices.size() < invalidDenseIndex && "Too many elements.");
+            auto denseIndex = static_cast<DenseIndex>(mDenseVector.size());
+            for (const auto index : indices) {
+                assert(index < mSize && "Invalid index id.");
+                assert(!has(index));
+                allocateSparsePageIfNecessary(index);
+                sparseEntry(index) = denseIndex++;
+            }
+            mDenseVector.insert(mDenseVector.end(), indices.begin(), indices.end());
+            if constexpr (HasStructOfArrays<Component>) {
+                for (auto& column : mColumns) {
+                    column.reserve(mDenseVector.size());
+                }
+                for (std::size_t i = 0; i < indices.size(); ++i) {
+                    StructOfArraysImpl::pushBack<Component>(mColumns, element);
+                }
+            } else {
+                mElementVector.reserve(mDenseVector.size());
+                for (std::size_t i = 0; i < indices.size(); ++i) {
+                    mElementVector.push_back(element);
+                }
+            }
         }
 
-        void remove(Entity index) noexcept;
+        void remove(Index index) noexcept;
 
+        // removes the elements of all given indices, large batches are removed in a single compacting pass
+        void removeMany(std::span<const Index> indices) noexcept;
+
+        void clear() noexcept;
+
+        void reserve(std::size_t elementCapacity) noexcept {
+            mDenseVector.reserve(elementCapacity);
+            if (!isStructOfArrays()) {
+                mElementVector.reserve(elementCapacity);
+            }
+            for (auto& column : mColumns) {
+                column.reserve(elementCapacity);
+            }
+        }
+
+        void swapDenseEntries(std::size_t firstDenseIndex, std::size_t secondDenseIndex) noexcept;
+
+        /* Returns the dense indices of the range [first, last) in the order that sorts the elements by
+         * the given comparator. Elements that compare equal keep their relative order when using
+         * insertion sort, which only needs last - first - 1 comparisons if the range is sorted already.
+         * The result lives in a scratch buffer that is reused (and overwritten) by the next call. */
+        template<typename T, typename Compare>
+        [[nodiscard]] std::span<const std::size_t> sortedOrder(std::size_t first,
+                                                               std::size_t last,
+                                                               Compare compare,
+                                                               SortAlgorithm algorithm) noexcept {
+            assert(first <= last && last <= mDenseVector.size());
+            auto& result = mSortOrderScratch;
+            result.resize(last - first);
+            std::iota(result.begin(), result.end(), first);
+            const auto compareIndices = [&](const std::size_t lhs, const std::size_t rhs) {
+                if constexpr (HasStructOfArrays<T>) {
+                    return compare(StructOfArraysImpl::gather<T>(mColumns, lhs),
+                                   StructOfArraysImpl::gather<T>(mColumns, rhs));
+                } else {
+                    return compare(mElementVector.get<T>(lhs), mElementVector.get<T>(rhs));
+                }
+            };
+            if (algorithm == SortAlgorithm::Standard) {
+                std::sort(result.begin(), result.end(), compareIndices);
+                return result;
+            }
+            for (std::size_t i = 1; i < result.size(); ++i) {
+                const auto current = result[i];
+                auto position = i;
+                // comparing with the predecessor first keeps already sorted entries at a single comparison
+                while (position > 0 && compareIndices(current, result[position - 1])) {
+                    result[position] = result[position - 1];
+                    --position;
+                }
+                result[position] = current;
+            }
+            return result;
+        }
+
+        // moves the entry with dense index order[i] to the dense index first + i
+        void permute(std::size_t first, std::span<const std::size_t> order) noexcept;
+
+        template<typename T, typename Compare>
+        void sort(Compare compare, SortAlgorithm algorithm = SortAlgorithm::Standard) noexcept {
+            permute(0, sortedOrder<T>(0, mDenseVector.size(), compare, algorithm));
+        }
+
+        // sparse pages are allocated on demand, so resizing only changes the valid index range
         void resize(std::size_t size) noexcept {
-            assert(size >= mSparseVector.size());
-            mSparseVector.resize(size, invalidEntity);
+            assert(size >= mSize);
+            mSize = size;
         }
 
         [[nodiscard]] std::size_t size() const noexcept {
-            return mSparseVector.size();
+            return mSize;
+        }
+        [[nodiscard]] std::uint64_t typeHash() const noexcept {
+            return mTypeHash;
         }
         [[nodiscard]] std::size_t elementCount() const noexcept {
-            return mElementVector.size();
+            return mDenseVector.size();
         }
-        [[nodiscard]] bool has(Entity index) const noexcept {
-            assert(index < mSparseVector.size() && "Invalid index id.");
-            const auto denseIndex = mSparseVector[index];
+        [[nodiscard]] bool has(Index index) const noexcept {
+            assert(index < mSize && "Invalid index id.");
+            const auto pageIndex = static_cast<std::size_t>(index / sparsePageSize);
+            if (pageIndex >= mSparsePages.size() || mSparsePages[pageIndex] == nullptr) {
+                return false;
+            }
+            const auto denseIndex = mSparsePages[pageIndex][index % sparsePageSize];
             return denseIndex < mDenseVector.size();
         }
 
+        [[nodiscard]] std::size_t denseIndex(Index index) const noexcept {
+            assert(has(index) && "The given index doesn't have an instance of this element.");
+            return static_cast<std::size_t>(sparseEntry(index));
+        }
+
         template<typename T>
-        [[nodiscard]] const T& get(Entity index) const noexcept {
+        [[nodiscard]] ComponentReference<const T> get(Index index) const noexcept {
             assert(has(index) && "The given index doesn't have an instance of this element.");
-            return mElementVector.get<T>(mSparseVector[index]);
+            return elementAt<T>(sparseEntry(index));
         }
 
-        [[nodiscard]] void* getTypeErasedMutable(Entity index) noexcept {
+        [[nodiscard]] void* getTypeErasedMutable(Index index) noexcept {
             assert(has(index) && "The given index doesn't have an instance of this element.");
-            return mElementVector[mSparseVector[index]];
+            assert(!isStructOfArrays() && "Structure of arrays storages cannot be accessed type erased.");
+            return mElementVector[sparseEntry(index)];
         }
 
-        [[nodiscard]] const void* getTypeErased(Entity index) const noexcept {
+        [[nodiscard]] const void* getTypeErased(Index index) const noexcept {
             assert(has(index) && "The given index doesn't have an instance of this element.");
-            return mElementVector[mSparseVector[index]];
+            assert(!isStructOfArrays() && "Structure of arrays storages cannot be accessed type erased.");
+            return mElementVector[sparseEntry(index)];
         }
 
         template<typename T>
-        [[nodiscard]] T& getMutable(Entity index) noexcept {
+        [[nodiscard]] ComponentReference<T> getMutable(Index index) noexcept {
             assert(has(index) && "The given index doesn't have an instance of this element.");
-            return mElementVector.get<T>(mSparseVector[index]);
+            return elementAtMutable<T>(sparseEntry(index));
         }
         [[nodiscard]] auto indices() const noexcept {
             return mDenseVector | ranges::views::all;
@@ -123,22 +260,132 @@ namespace c2k {
 
         template<typename T>
         [[nodiscard]] auto elements() const noexcept {
-            return ranges::subrange(mElementVector.template begin<T>(), mElementVector.template end<T>());
+            if constexpr (std::is_empty_v<T>) {
+                return emptyElements<const T>();
+            } else if constexpr (HasStructOfArrays<T>) {
+                return ranges::subrange(StructOfArraysIterator<T, true>{ &mColumns, 0 },
+                                        StructOfArraysIterator<T, true>{ &mColumns, mDenseVector.size() });
+            } else {
+                return ranges::subrange(mElementVector.template begin<T>(), mElementVector.template end<T>());
+            }
         }
 
         template<typename T>
         [[nodiscard]] auto elementsMutable() noexcept {
-            return ranges::subrange(mElementVector.template begin<T>(), mElementVector.template end<T>());
+            if constexpr (std::is_empty_v<T>) {
+                return emptyElements<T>();
+            } else if constexpr (HasStructOfArrays<T>) {
+                return ranges::subrange(StructOfArraysIterator<T, false>{ &mColumns, 0 },
+                                        StructOfArraysIterator<T, false>{ &mColumns, mDenseVector.size() });
+            } else {
+                return ranges::subrange(mElementVector.template begin<T>(), mElementVector.template end<T>());
+            }
+        }
+
+        // tag components (empty types) only occupy the sparse and dense index arrays
+        [[nodiscard]] bool isTagStorage() const noexcept {
+            return mElementVector.isZeroSized();
+        }
+
+        [[nodiscard]] bool isStructOfArrays() const noexcept {
+            return mStructOfArraysOperations != nullptr;
+        }
+
+        /* Contiguous array of a single member of all components (in dense order), only available for
+         * components that are stored as structure of arrays. The column is aligned for SIMD loads. */
+        template<auto member>
+        [[nodiscard]] auto column() const noexcept {
+            const auto data = static_cast<const ColumnMember<member>*>(mColumns[columnIndex<member>()].data());
+            return std::span{ data, mDenseVector.size() };
+        }
+
+        template<auto member>
+        [[nodiscard]] auto columnMutable() noexcept {
+            const auto data = static_cast<ColumnMember<member>*>(mColumns[columnIndex<member>()].data());
+            return std::span{ data, mDenseVector.size() };
         }
 
         [[nodiscard]] auto typeErasedElements() const noexcept {
             return ranges::subrange(mElementVector.cbegin(), mElementVector.cend());
         }
 
+        void writeSnapshot(SnapshotWriter& writer) const noexcept;
+
+        /* Skips the data that readSnapshot() would read and checks whether it fits this storage. Only indices
+         * marked in validIndices may have an element. On success, count and elements describe the elements
+         * within the snapshot, which are laid out like an array of the component type (but may be unaligned). */
+        [[nodiscard]] bool validateSnapshot(SnapshotReader& reader,
+                                            const std::vector<bool>& validIndices,
+                                            std::size_t& count,
+                                            const std::byte*& elements) const noexcept;
+
+        // replaces all elements, the snapshot has to be validated before (see validateSnapshot())
+        void readSnapshot(SnapshotReader& reader) noexcept;
+
+    private:
+        [[nodiscard]] DenseIndex& sparseEntry(Index index) noexcept {
+            assert(index / sparsePageSize < mSparsePages.size() && mSparsePages[index / sparsePageSize] != nullptr);
+            return mSparsePages[index / sparsePageSize][index % sparsePageSize];
+        }
+
+        [[nodiscard]] DenseIndex sparseEntry(Index index) const noexcept {
+            assert(index / sparsePageSize < mSparsePages.size() && mSparsePages[index / sparsePageSize] != nullptr);
+            return mSparsePages[index / sparsePageSize][index % sparsePageSize];
+        }
+
+        void allocateSparsePageIfNecessary(Index index) noexcept;
+
+        template<auto member>
+        using ColumnMember = typename StructOfArraysImpl::MemberPointerTraits<decltype(member)>::MemberType;
+
+        template<auto member>
+        [[nodiscard]] std::size_t columnIndex() const noexcept {
+            using Component = typename StructOfArraysImpl::MemberPointerTraits<decltype(member)>::ClassType;
+            static_assert(HasStructOfArrays<Component>, "The component is not stored as structure of arrays.");
+            constexpr auto result = StructOfArraysImpl::columnIndex<Component, member>();
+            static_assert(result < StructOfArraysImpl::numColumns<Component>, "The member has no column.");
+            assert(result < mColumns.size() && "Component type mismatch.");
+            return result;
+        }
+
+        template<typename T>
+        [[nodiscard]] ComponentReference<const T> elementAt(std::size_t denseIndex) const noexcept {
+            if constexpr (HasStructOfArrays<T>) {
+                return StructOfArraysImpl::reference<T>(mColumns, denseIndex);
+            } else {
+                return mElementVector.get<T>(denseIndex);
+            }
+        }
+
+        template<typename T>
+        [[nodiscard]] ComponentReference<T> elementAtMutable(std::size_t denseIndex) noexcept {
+            if constexpr (HasStructOfArrays<T>) {
+                return StructOfArraysImpl::reference<T>(mColumns, denseIndex);
+            } else {
+                return mElementVector.get<T>(denseIndex);
+            }
+        }
+
+        // yields the shared instance once per entity so that tags can be zipped with other components
+        template<typename T>
+        [[nodiscard]] auto emptyElements() const noexcept {
+            return mDenseVector | ranges::views::transform([](Index) -> T& {
+                       return TypeErasedVector::emptyInstance<std::remove_const_t<T>>();
+                   });
+        }
+
     private:
-        std::vector<Entity> mSparseVector;
-        std::vector<Entity> mDenseVector;
-        TypeErasedVector mElementVector;
+        std::size_t mSize;
+        std::vector<std::unique_ptr<DenseIndex[]>> mSparsePages;
+        std::vector<Index> mDenseVector;
+        TypeErasedVector mElementVector;// stays empty for structure of arrays storages
+        std::vector<TypeErasedVector> mColumns;// one per member for structure of arrays storages
+        const SnapshotOperations* mSnapshotOperations;
+        const StructOfArraysOperations* mStructOfArraysOperations;
+        std::uint64_t mTypeHash;
+        // reused between calls of sortedOrder() and permute() since sorting may happen every frame
+        std::vector<std::size_t> mSortOrderScratch;
+        std::vector<bool> mPermutedScratch;
     };
 
 }// namespace c2k
\ No newline at end of file
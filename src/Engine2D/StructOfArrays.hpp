@@ -0,0 +1,275 @@
+//
+// Created by coder2k on 12.12.2021.
+//
+
+#pragma once
+
+#include "Snapshot.hpp"
+#include "TypeErasedVector.hpp"
+#include <compare>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace c2k {
+
+    struct NoStructOfArrays { };
+
+    /* Specialize this to store a component type as a structure of arrays: every data member lives in its own
+     * aligned column, so systems that only touch a few members don't have to load the others. Needed:
+     *  - members: a std::tuple of pointers to all data members of the component
+     *  - template<bool isConst> struct Reference: an aggregate of ColumnReference<Member, isConst> fields with
+     *    the same names (and in the same order) as the members
+     * Views and callbacks hand out Reference proxies instead of component references for those types. */
+    template<typename Component>
+    struct StructOfArrays : NoStructOfArrays { };
+
+    template<typename Component>
+    concept HasStructOfArrays = !std::is_base_of_v<NoStructOfArrays, StructOfArrays<Component>>;
+
+    template<typename Member, bool isConst>
+    using ColumnReference = std::conditional_t<isConst, const Member&, Member&>;
+
+    namespace StructOfArraysImpl {
+
+        // a cache line, which is enough for every SIMD register width
+        inline constexpr std::size_t columnAlignment = 64;
+
+        template<typename MemberPointer>
+        struct MemberPointerTraits;
+
+        template<typename Class, typename Member>
+        struct MemberPointerTraits<Member Class::*> {
+            using ClassType = Class;
+            using MemberType = Member;
+        };
+
+        template<typename Component>
+        struct ReferenceType {
+            using type = Component&;
+        };
+
+        template<typename Component>
+        requires HasStructOfArrays<std::remove_const_t<Component>>
+        struct ReferenceType<Component> {
+            using type = typename StructOfArrays<std::remove_const_t<Component>>::template Reference<
+                    std::is_const_v<Component>>;
+        };
+
+        template<typename Component>
+        inline constexpr std::size_t numColumns = std::tuple_size_v<decltype(StructOfArrays<Component>::members)>;
+
+        template<typename Component, std::size_t column>
+        using ColumnType = typename MemberPointerTraits<
+                std::tuple_element_t<column, std::remove_const_t<decltype(StructOfArrays<Component>::members)>>>::
+                MemberType;
+
+        template<typename Component>
+        [[nodiscard]] constexpr auto forEachColumn(auto&& function) {
+            return [&]<std::size_t... columns>(std::index_sequence<columns...>) {
+                return function(std::integral_constant<std::size_t, columns>{}...);
+            }(std::make_index_sequence<numColumns<Component>>{});
+        }
+
+        template<typename Component, auto member, std::size_t column>
+        [[nodiscard]] consteval bool storesMember() {
+            constexpr auto candidate = std::get<column>(StructOfArrays<Component>::members);
+            if constexpr (std::is_same_v<std::remove_const_t<decltype(candidate)>, decltype(member)>) {
+                return candidate == member;
+            } else {
+                return false;
+            }
+        }
+
+        // index of the column that stores the given member (numColumns if it is not part of the layout)
+        template<typename Component, auto member>
+        [[nodiscard]] consteval std::size_t columnIndex() {
+            return forEachColumn<Component>([](auto... column) {
+                std::size_t result{ numColumns<Component> };
+                ((result = (storesMember<Component, member, column>() ? column : result)), ...);
+                return result;
+            });
+        }
+
+        template<typename Component>
+        [[nodiscard]] std::vector<TypeErasedVector> createColumns() noexcept {
+            std::vector<TypeErasedVector> result;
+            result.reserve(numColumns<Component>);
+            forEachColumn<Component>([&](auto... column) {
+                (result.push_back(TypeErasedVector::forType<ColumnType<Component, column>>(columnAlignment)), ...);
+            });
+            return result;
+        }
+
+        template<typename Component>
+        void pushBack(std::vector<TypeErasedVector>& columns, const Component& component) noexcept {
+            forEachColumn<Component>([&](auto... column) {
+                (columns[column].push_back(component.*std::get<column>(StructOfArrays<Component>::members)), ...);
+            });
+        }
+
+        // returns a Reference<true> for const columns and a Reference<false> otherwise
+        template<typename Component, typename Columns>
+        [[nodiscard]] auto reference(Columns& columns, std::size_t denseIndex) noexcept {
+            using Reference = typename StructOfArrays<Component>::template Reference<std::is_const_v<Columns>>;
+            return forEachColumn<Component>([&](auto... column) {
+                return Reference{ columns[column].template get<ColumnType<Component, column>>(denseIndex)... };
+            });
+        }
+
+        template<typename Component>
+        [[nodiscard]] Component gather(const std::vector<TypeErasedVector>& columns, std::size_t denseIndex) noexcept {
+            Component result{};
+            forEachColumn<Component>([&](auto... column) {
+                ((result.*std::get<column>(StructOfArrays<Component>::members) =
+                          columns[column].template get<ColumnType<Component, column>>(denseIndex)),
+                 ...);
+            });
+            return result;
+        }
+
+    }// namespace StructOfArraysImpl
+
+    // what views hand out for a (possibly const qualified) component type
+    template<typename Component>
+    using ComponentReference = typename StructOfArraysImpl::ReferenceType<Component>::type;
+
+    // random access iterator over the components of a structure of arrays storage, yields Reference proxies
+    template<typename Component, bool isConst>
+    class StructOfArraysIterator final {
+    public:
+        using Columns = std::conditional_t<isConst, const std::vector<TypeErasedVector>, std::vector<TypeErasedVector>>;
+        using iterator_category = std::random_access_iterator_tag;
+        using difference_type = std::ptrdiff_t;
+        using value_type = typename StructOfArrays<Component>::template Reference<isConst>;
+        using reference = value_type;
+
+        StructOfArraysIterator() noexcept = default;
+
+        StructOfArraysIterator(Columns* columns, std::size_t index) noexcept : mColumns{ columns }, mIndex{ index } { }
+
+        [[nodiscard]] reference operator*() const noexcept {
+            return StructOfArraysImpl::reference<Component>(*mColumns, mIndex);
+        }
+
+        [[nodiscard]] reference operator[](difference_type offset) const noexcept {
+            return *((*this) + offset);
+        }
+
+        StructOfArraysIterator& operator++() noexcept {
+            ++mIndex;
+            return *this;
+        }
+
+        StructOfArraysIterator operator++(int) noexcept {
+            const auto copy{ *this };
+            ++(*this);
+            return copy;
+        }
+
+        StructOfArraysIterator& operator--() noexcept {
+            --mIndex;
+            return *this;
+        }
+
+        StructOfArraysIterator operator--(int) noexcept {
+            const auto copy{ *this };
+            --(*this);
+            return copy;
+        }
+
+        StructOfArraysIterator& operator+=(difference_type offset) noexcept {
+            mIndex = static_cast<std::size_t>(static_cast<difference_type>(mIndex) + offset);
+            return *this;
+        }
+
+        StructOfArraysIterator& operator-=(difference_type offset) noexcept {
+            return (*this) += -offset;
+        }
+
+        [[nodiscard]] StructOfArraysIterator operator+(difference_type offset) const noexcept {
+            auto result{ *this };
+            return result += offset;
+        }
+
+        [[nodiscard]] friend StructOfArraysIterator operator+(difference_type offset,
+                                                              const StructOfArraysIterator& iterator) noexcept {
+            return iterator + offset;
+        }
+
+        [[nodiscard]] StructOfArraysIterator operator-(difference_type offset) const noexcept {
+            auto result{ *this };
+            return result -= offset;
+        }
+
+        [[nodiscard]] difference_type operator-(const StructOfArraysIterator& other) const noexcept {
+            return static_cast<difference_type>(mIndex) - static_cast<difference_type>(other.mIndex);
+        }
+
+        [[nodiscard]] bool operator==(const StructOfArraysIterator& other) const noexcept {
+            return mIndex == other.mIndex;
+        }
+
+        [[nodiscard]] auto operator<=>(const StructOfArraysIterator& other) const noexcept {
+            return mIndex <=> other.mIndex;
+        }
+
+    private:
+        Columns* mColumns{ nullptr };
+        std::size_t mIndex{ 0 };
+    };
+
+    // snapshots store components of structure of arrays storages in their regular (interleaved) layout
+    struct StructOfArraysOperations {
+        void (*writeSnapshot)(const std::vector<TypeErasedVector>& columns,
+                              const SnapshotOperations& operations,
+                              SnapshotWriter& writer);
+        void (*readSnapshot)(std::vector<TypeErasedVector>& columns,
+                             const SnapshotOperations& operations,
+                             const std::byte* data,
+                             std::size_t count,
+                             const SnapshotReader& reader);
+    };
+
+    template<typename Component>
+    [[nodiscard]] const StructOfArraysOperations* structOfArraysOperationsFor() noexcept {
+        using namespace StructOfArraysImpl;
+        if constexpr (!HasStructOfArrays<Component>) {
+            return nullptr;
+        } else {
+            static constexpr StructOfArraysOperations operations{
+                .writeSnapshot{ [](const std::vector<TypeErasedVector>& columns,
+                                   const SnapshotOperations& snapshotOperations, SnapshotWriter& writer) {
+                    std::vector<Component> components;
+                    components.reserve(columns.front().size());
+                    for (std::size_t i = 0; i < columns.front().size(); ++i) {
+                        components.push_back(gather<Component>(columns, i));
+                    }
+                    snapshotOperations.write(components.data(), components.size(), writer);
+                } },
+                .readSnapshot{ [](std::vector<TypeErasedVector>& columns, const SnapshotOperations& snapshotOperations,
+                                  const std::byte* data, std::size_t count, const SnapshotReader& reader) {
+                    std::vector<Component> components(count);
+                    if (count > 0) {
+                        std::memcpy(components.data(), data, count * sizeof(Component));
+                    }
+                    if (snapshotOperations.resolveAssets != nullptr) {
+                        snapshotOperations.resolveAssets(components.data(), count, reader);
+                    }
+                    for (auto& column : columns) {
+                        column.resize(0);
+                    }
+                    for (const auto& component : components) {
+                        pushBack(columns, component);
+                    }
+                } },
+            };
+            return &operations;
+        }
+    }
+
+}// namespace c2k
\ No newline at end of file
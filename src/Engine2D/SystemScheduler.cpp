@@ -0,0 +1,103 @@
+//
+// Created by coder2k on 04.12.2021.
+//
+
+#include "SystemScheduler.hpp"
+#include <chrono>
+
+namespace c2k {
+
+    bool SystemAccess::conflictsWith(const SystemAccess& other) const noexcept {
+        if (mIsExclusive || other.mIsExclusive) {
+            return true;
+        }
+        auto sharedComponents = (mWrites & (other.mReads | other.mWrites)) | (other.mWrites & mReads);
+        if (mWith.intersects(other.mWithout) || mWithout.intersects(other.mWith)) {
+            // the filtered entities are disjoint, so the components both systems filter by are never shared
+            sharedComponents.subtract(mWith & other.mWith);
+        }
+        return sharedComponents.any();
+    }
+
+    SystemScheduler::SystemScheduler(JobSystem& jobSystem) noexcept : mJobSystem{ jobSystem } { }
+
+    void SystemScheduler::addSystem(std::string name, const SystemAccess& access, System system) noexcept {
+        const auto systemIndex = mSystems.size();
+        SystemEntry entry{ .system{ std::move(system) }, .access{ access }, .dependents{}, .numDependencies{ 0 } };
+        for (std::size_t i = 0; i < systemIndex; ++i) {
+            if (mSystems[i].access.conflictsWith(access)) {
+                mSystems[i].dependents.push_back(systemIndex);
+                ++entry.numDependencies;
+            }
+        }
+        mSystems.push_back(std::move(entry));
+        mTimings.push_back(SystemTiming{ .name{ std::move(name) } });
+        mRemainingDependencies = std::make_unique<std::atomic<std::size_t>[]>(mSystems.size());
+    }
+
+    void SystemScheduler::run() noexcept {
+        mNumFinishedSystems = 0;
+        for (std::size_t i = 0; i < mSystems.size(); ++i) {
+            mRemainingDependencies[i] = mSystems[i].numDependencies;
+        }
+        for (std::size_t i = 0; i < mSystems.size(); ++i) {
+            if (mSystems[i].numDependencies == 0) {
+                launch(i);
+            }
+        }
+        // exclusive systems are executed by this thread, in the meantime it helps out with other jobs
+        const auto canContinue = [this] {
+            std::scoped_lock lock{ mExclusiveSystemsMutex };
+            return !mReadyExclusiveSystems.empty() ||
+                   mNumFinishedSystems.load(std::memory_order_acquire) == mSystems.size();
+        };
+        while (true) {
+            mJobSystem.waitUntil(canContinue);
+            std::size_t exclusiveSystem = mSystems.size();
+            {
+                std::scoped_lock lock{ mExclusiveSystemsMutex };
+                if (!mReadyExclusiveSystems.empty()) {
+                    exclusiveSystem = mReadyExclusiveSystems.back();
+                    mReadyExclusiveSystems.pop_back();
+                }
+            }
+            if (exclusiveSystem == mSystems.size()) {
+                break;
+            }
+            execute(exclusiveSystem);
+        }
+        mJobSystem.wait(mJobCounter);
+    }
+
+    void SystemScheduler::launch(std::size_t systemIndex) noexcept {
+        if (mSystems[systemIndex].access.isExclusive()) {
+            {
+                std::scoped_lock lock{ mExclusiveSystemsMutex };
+                mReadyExclusiveSystems.push_back(systemIndex);
+            }
+            mJobSystem.notifyWaitingThreads();
+            return;
+        }
+        mJobSystem.schedule([this, systemIndex] { execute(systemIndex); }, mJobCounter);
+    }
+
+    void SystemScheduler::execute(std::size_t systemIndex) noexcept {
+        const auto startTime = std::chrono::high_resolution_clock::now();
+        mSystems[systemIndex].system();
+        const auto duration =
+                std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - startTime).count();
+        auto& timing = mTimings[systemIndex];
+        timing.lastDuration = duration;
+        timing.totalDuration += duration;
+        ++timing.numRuns;
+        for (const auto dependent : mSystems[systemIndex].dependents) {
+            if (mRemainingDependencies[dependent].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                launch(dependent);
+            }
+        }
+        if (mNumFinishedSystems.fetch_add(1, std::memory_order_acq_rel) + 1 == mSystems.size()) {
+            mJobSystem.notifyWaitingThreads();
+        }
+    }
+
+}// namespace c2k
\ No newline at end of file
@@ -0,0 +1,131 @@
+//
+// Created by coder2k on 04.12.2021.
+//
+
+#pragma once
+
+#include "JobSystem.hpp"
+#include "Registry.hpp"
+#include "TypeIdentifier.hpp"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace c2k {
+
+    /* Declares which component types a system accesses. Components declared via with() are only accessed
+     * on entities that have all the components of with() and none of the components of without(), all
+     * other components may be accessed on any entity. Exclusive systems may change the structure of the
+     * registry or use the OpenGL context, so they never run concurrently with other systems and always
+     * run on the thread that calls SystemScheduler::run(). */
+    class SystemAccess final {
+    public:
+        using ComponentSignature = Registry::ComponentSignature;
+
+    public:
+        template<typename... Components>
+        SystemAccess& reads() noexcept {
+            (mReads.set(bit<Components>()), ...);
+            return *this;
+        }
+
+        template<typename... Components>
+        SystemAccess& writes() noexcept {
+            (mWrites.set(bit<Components>()), ...);
+            return *this;
+        }
+
+        template<typename... Components>
+        SystemAccess& with() noexcept {
+            (mWith.set(bit<Components>()), ...);
+            return *this;
+        }
+
+        template<typename... Components>
+        SystemAccess& without() noexcept {
+            (mWithout.set(bit<Components>()), ...);
+            return *this;
+        }
+
+        SystemAccess& exclusive() noexcept {
+            mIsExclusive = true;
+            return *this;
+        }
+
+        [[nodiscard]] bool isExclusive() const noexcept {
+            return mIsExclusive;
+        }
+
+        [[nodiscard]] bool conflictsWith(const SystemAccess& other) const noexcept;
+
+    private:
+        template<typename Component>
+        [[nodiscard]] static std::size_t bit() noexcept {
+            return TypeIdentifier::get<Component>();
+        }
+
+    private:
+        ComponentSignature mReads;
+        ComponentSignature mWrites;
+        ComponentSignature mWith;
+        ComponentSignature mWithout;
+        bool mIsExclusive{ false };
+    };
+
+    struct SystemTiming {
+        std::string name;
+        double lastDuration{ 0.0 };// in seconds
+        double totalDuration{ 0.0 };
+        std::uint64_t numRuns{ 0 };
+
+        [[nodiscard]] double meanDuration() const noexcept {
+            return numRuns == 0 ? 0.0 : totalDuration / static_cast<double>(numRuns);
+        }
+    };
+
+    /* Runs a list of systems once per call to run(). Systems whose accesses conflict run in the order
+     * they have been added, all other systems are executed concurrently on the job system. */
+    class SystemScheduler final {
+    public:
+        using System = std::function<void()>;
+
+    public:
+        explicit SystemScheduler(JobSystem& jobSystem) noexcept;
+
+        void addSystem(std::string name, const SystemAccess& access, System system) noexcept;
+        void run() noexcept;
+
+        // indexed in the order the systems have been added
+        [[nodiscard]] std::span<const SystemTiming> timings() const noexcept {
+            return mTimings;
+        }
+
+    private:
+        struct SystemEntry {
+            System system;
+            SystemAccess access;
+            std::vector<std::size_t> dependents;// systems that have to wait for this one
+            std::size_t numDependencies{ 0 };
+        };
+
+    private:
+        void launch(std::size_t systemIndex) noexcept;
+        void execute(std::size_t systemIndex) noexcept;
+
+    private:
+        JobSystem& mJobSystem;
+        std::vector<SystemEntry> mSystems;
+        std::vector<SystemTiming> mTimings;
+        std::unique_ptr<std::atomic<std::size_t>[]> mRemainingDependencies;
+        std::atomic<std::size_t> mNumFinishedSystems{ 0 };
+        JobCounter mJobCounter{ 0 };
+        std::mutex mExclusiveSystemsMutex;
+        std::vector<std::size_t> mReadyExclusiveSystems;
+    };
+
+}// namespace c2k
\ No newline at end of file
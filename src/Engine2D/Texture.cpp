@@ -135,7 +135,9 @@ namespace c2k {
     }
 
     Texture::~Texture() {
-        glDeleteTextures(1, &mName);
+        if (mName != 0U) {
+            glDeleteTextures(1, &mName);
+        }
     }
 
     Texture& Texture::operator=(Texture&& other) noexcept {
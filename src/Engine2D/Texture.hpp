@@ -70,6 +70,8 @@ namespace c2k {
         GLuint mName{ 0U };
 
         friend class Renderer;
+        friend class OpenGLRenderBackend;
+        friend class RecordingRenderBackend;
     };
 
 }// namespace c2k
\ No newline at end of file
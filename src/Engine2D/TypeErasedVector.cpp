@@ -4,6 +4,10 @@
 
 #include "TypeErasedVector.hpp"
 #include <range/v3/all.hpp>
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <utility>
 
 static constexpr std::size_t getPaddedSize(std::size_t size, std::size_t alignment) noexcept {
     auto result{ alignment };
@@ -15,22 +19,30 @@ static constexpr std::size_t getPaddedSize(std::size_t size, std::size_t alignme
 
 namespace c2k {
 
+    TypeErasedVector::TypeErasedVector(TypeErasedVector&& other) noexcept
+        : mSize{ std::exchange(other.mSize, 0) },
+          mCapacity{ std::exchange(other.mCapacity, 0) },
+          mData{ std::exchange(other.mData, nullptr) },
+          mElementSize{ other.mElementSize },
+          mElementAlignment{ other.mElementAlignment },
+          mElementSizePadded{ other.mElementSizePadded },
+          mBufferAlignment{ other.mBufferAlignment },
+          mOperations{ other.mOperations } { }
+
     TypeErasedVector::~TypeErasedVector() {
-        using ranges::views::ints;
-        void* current{ mData };
-        for ([[maybe_unused]] auto _ : ints(std::size_t{ 0 }, mSize)) {
-            mDestructor(current);
-            current = static_cast<std::uint8_t*>(current) + mElementSizePadded;
+        if (isZeroSized()) {
+            return;
         }
-        ::operator delete[](mData, std::align_val_t{ mElementAlignment });
+        destroyRange(0, mSize);
+        ::operator delete[](mData, std::align_val_t{ mBufferAlignment });
     }
 
     TypeErasedVector::Iterator TypeErasedVector::begin() noexcept {
-        return Iterator{ mData, mElementSizePadded };
+        return Iterator{ mData, mElementSizePadded, 0 };
     }
 
     TypeErasedVector::ConstIterator TypeErasedVector::begin() const noexcept {
-        return ConstIterator{ mData, mElementSizePadded };
+        return ConstIterator{ mData, mElementSizePadded, 0 };
     }
 
     TypeErasedVector::ConstIterator TypeErasedVector::cbegin() const noexcept {
@@ -38,11 +50,12 @@ namespace c2k {
     }
 
     TypeErasedVector::Iterator TypeErasedVector::end() noexcept {
-        return Iterator{ static_cast<std::uint8_t*>(mData) + mSize * mElementSizePadded, mElementSizePadded };
+        return Iterator{ static_cast<std::uint8_t*>(mData) + mSize * mElementSizePadded, mElementSizePadded, mSize };
     }
 
     TypeErasedVector::ConstIterator TypeErasedVector::end() const noexcept {
-        return ConstIterator{ static_cast<std::uint8_t*>(mData) + mSize * mElementSizePadded, mElementSizePadded };
+        return ConstIterator{ static_cast<std::uint8_t*>(mData) + mSize * mElementSizePadded, mElementSizePadded,
+                              mSize };
     }
 
     TypeErasedVector::ConstIterator TypeErasedVector::cend() const noexcept {
@@ -50,9 +63,40 @@ namespace c2k {
     }
 
     void TypeErasedVector::swapElements(std::size_t firstIndex, std::size_t secondIndex) noexcept {
+        if (isZeroSized()) {
+            return;
+        }
         void* const firstAddress = static_cast<std::uint8_t*>(mData) + firstIndex * mElementSizePadded;
         void* const secondAddress = static_cast<std::uint8_t*>(mData) + secondIndex * mElementSizePadded;
-        mSwap(firstAddress, secondAddress);
+        if (mOperations->isTriviallyRelocatable) {
+            const auto firstBytes = static_cast<std::byte*>(firstAddress);
+            std::swap_ranges(firstBytes, firstBytes + mElementSize, static_cast<std::byte*>(secondAddress));
+        } else {
+            mOperations->swap(firstAddress, secondAddress);
+        }
+    }
+
+    void TypeErasedVector::swapRemove(std::size_t index) noexcept {
+        assert(index < mSize);
+        if (isZeroSized()) {
+            --mSize;
+            return;
+        }
+        const auto lastIndex = mSize - 1;
+        void* const address = static_cast<std::uint8_t*>(mData) + index * mElementSizePadded;
+        void* const lastAddress = static_cast<std::uint8_t*>(mData) + lastIndex * mElementSizePadded;
+        if (mOperations->isTriviallyRelocatable) {
+            if (index != lastIndex) {
+                std::memcpy(address, lastAddress, mElementSize);
+            }
+        } else {
+            if (index != lastIndex) {
+                mOperations->destruct(address);
+                mOperations->moveConstruct(address, lastAddress);
+            }
+            mOperations->destruct(lastAddress);
+        }
+        --mSize;
     }
 
     void TypeErasedVector::resize(std::size_t size) noexcept {
@@ -60,64 +104,90 @@ namespace c2k {
         if (size == mSize) {
             return;
         }
-        // TODO: maybe only grow to the minimum size that is needed and not only use powers of 2
-        while (mCapacity < size) {
-            grow();
+        if (isZeroSized()) {
+            mSize = size;
+            return;
         }
+        reserve(size);
         if (size > mSize) {
             void* const baseAddress{ static_cast<std::uint8_t*>(mData) + mSize * mElementSizePadded };
             void* currentAddress{ baseAddress };
             for ([[maybe_unused]] auto _ : ints(mSize, size)) {
-                mDefaultConstruct(currentAddress);
+                mOperations->defaultConstruct(currentAddress);
                 currentAddress = static_cast<std::uint8_t*>(currentAddress) + mElementSizePadded;
             }
         } else if (size < mSize) {
-            void* const baseAddress{ static_cast<std::uint8_t*>(mData) + size * mElementSizePadded };
-            void* currentAddress{ baseAddress };
-            for ([[maybe_unused]] auto _ : ints(size, mSize)) {
-                mDestructor(currentAddress);
-                currentAddress = static_cast<std::uint8_t*>(currentAddress) + mElementSizePadded;
-            }
+            destroyRange(size, mSize);
         }
         mSize = size;
     }
 
+    void TypeErasedVector::assignBytes(const void* source, std::size_t count) noexcept {
+        assert(mOperations->isTriviallyRelocatable && "Elements cannot be copied bytewise.");
+        mSize = 0;
+        reserve(count);
+        if (count > 0 && !isZeroSized()) {
+            std::memcpy(mData, source, count * mElementSizePadded);
+        }
+        mSize = count;
+    }
+
     TypeErasedVector::TypeErasedVector(std::size_t elementSize,
                                        std::size_t elementAlignment,
-                                       std::function<void(void*)> defaultConstruct,
-                                       std::function<void(void*)> destructor,
-                                       std::function<void(void*, void*)> placementNew,
-                                       std::function<void(void*, void*)> swap) noexcept
-        : mElementSize{ elementSize },
+                                       std::size_t bufferAlignment,
+                                       const ElementOperations* operations,
+                                       void* sharedElement) noexcept
+        : mData{ sharedElement },
+          mElementSize{ elementSize },
           mElementAlignment{ elementAlignment },
-          mElementSizePadded{ getPaddedSize(elementSize, elementAlignment) },
-          mDefaultConstruct{ std::move(defaultConstruct) },
-          mDestructor{ std::move(destructor) },
-          mPlacementNew{ std::move(placementNew) },
-          mSwap{ std::move(swap) } { }
+          mElementSizePadded{ sharedElement == nullptr ? getPaddedSize(elementSize, elementAlignment) : 0 },
+          mBufferAlignment{ std::max(elementAlignment, bufferAlignment) },
+          mOperations{ operations } {
+        if (sharedElement != nullptr) {
+            // nothing is ever allocated, so the vector must never try to grow
+            mCapacity = std::numeric_limits<std::size_t>::max();
+        }
+    }
 
     void TypeErasedVector::grow() noexcept {
+        reallocate(mCapacity > 0 ? 2 * mCapacity : 1);
+    }
+
+    void TypeErasedVector::reallocate(std::size_t newCapacity) noexcept {
         using ranges::views::ints;
-        const std::size_t newCapacity{ mCapacity > 0 ? 2 * mCapacity : 1 };
+        assert(newCapacity >= mSize);
         void* const newBuffer =
-                ::operator new[](newCapacity* mElementSizePadded, std::align_val_t{ mElementAlignment });
-        void* writePointer{ newBuffer };
-        void* readPointer{ mData };
-        for ([[maybe_unused]] auto _ : ints(std::size_t{ 0 }, mSize)) {
-            mPlacementNew(writePointer, readPointer);
-            readPointer = static_cast<std::uint8_t*>(readPointer) + mElementSizePadded;
-            writePointer = static_cast<std::uint8_t*>(writePointer) + mElementSizePadded;
-        }
-        if (mCapacity > 0) {
-            void* current{ mData };
+                ::operator new[](newCapacity* mElementSizePadded, std::align_val_t{ mBufferAlignment });
+        if (mOperations->isTriviallyRelocatable) {
+            if (mSize > 0) {
+                std::memcpy(newBuffer, mData, mSize * mElementSizePadded);
+            }
+        } else {
+            void* writePointer{ newBuffer };
+            void* readPointer{ mData };
             for ([[maybe_unused]] auto _ : ints(std::size_t{ 0 }, mSize)) {
-                mDestructor(current);
-                current = static_cast<std::uint8_t*>(current) + mElementSizePadded;
+                mOperations->moveConstruct(writePointer, readPointer);
+                readPointer = static_cast<std::uint8_t*>(readPointer) + mElementSizePadded;
+                writePointer = static_cast<std::uint8_t*>(writePointer) + mElementSizePadded;
             }
-            ::operator delete[](mData, std::align_val_t{ mElementAlignment });
+            destroyRange(0, mSize);
+        }
+        if (mCapacity > 0) {
+            ::operator delete[](mData, std::align_val_t{ mBufferAlignment });
         }
         mData = newBuffer;
         mCapacity = newCapacity;
     }
 
+    void TypeErasedVector::destroyRange(std::size_t first, std::size_t last) noexcept {
+        if (mOperations->isTriviallyDestructible) {
+            return;
+        }
+        void* current{ static_cast<std::uint8_t*>(mData) + first * mElementSizePadded };
+        for (auto i = first; i < last; ++i) {
+            mOperations->destruct(current);
+            current = static_cast<std::uint8_t*>(current) + mElementSizePadded;
+        }
+    }
+
 }// namespace c2k
\ No newline at end of file
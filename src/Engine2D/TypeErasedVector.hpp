@@ -5,11 +5,13 @@
 #pragma once
 
 #include "Iterators.hpp"
+#include <algorithm>
 #include <cassert>
 #include <cstdint>
 #include <cstddef>
-#include <functional>
+#include <concepts>
 #include <new>
+#include <type_traits>
 #include <utility>
 
 namespace c2k {
@@ -24,7 +26,11 @@ namespace c2k {
         using ConstTypedIterator = const T*;
 
     public:
+        TypeErasedVector(const TypeErasedVector&) = delete;
+        TypeErasedVector(TypeErasedVector&& other) noexcept;
         ~TypeErasedVector();
+        TypeErasedVector& operator=(const TypeErasedVector&) = delete;
+        TypeErasedVector& operator=(TypeErasedVector&&) = delete;
 
         [[nodiscard]] Iterator begin() noexcept;
         [[nodiscard]] ConstIterator begin() const noexcept;
@@ -55,6 +61,7 @@ namespace c2k {
 
         template<std::default_initializable T>
         [[nodiscard]] TypedIterator<T> end() noexcept {
+            assert(!isZeroSized() && "Zero-sized elements cannot be iterated via pointers.");
             assert(sizeof(T) == mElementSize);
             assert(alignof(T) == mElementAlignment);
             return static_cast<TypedIterator<T>>(mData) + mSize;
@@ -62,6 +69,7 @@ namespace c2k {
 
         template<std::default_initializable T>
         [[nodiscard]] ConstTypedIterator<T> end() const noexcept {
+            assert(!isZeroSized() && "Zero-sized elements cannot be iterated via pointers.");
             assert(sizeof(T) == mElementSize);
             assert(alignof(T) == mElementAlignment);
             return static_cast<ConstTypedIterator<T>>(mData) + mSize;
@@ -82,10 +90,24 @@ namespace c2k {
             return static_cast<std::uint8_t*>(mData) + mElementSizePadded * index;
         }
 
+        [[nodiscard]] void* data() noexcept {
+            return mData;
+        }
+
+        [[nodiscard]] const void* data() const noexcept {
+            return mData;
+        }
+
         void swapElements(std::size_t firstIndex, std::size_t secondIndex) noexcept;
 
+        // moves the last element into the given slot and shrinks the vector by one
+        void swapRemove(std::size_t index) noexcept;
+
         void resize(std::size_t size) noexcept;
 
+        // replaces all elements by a bytewise copy of count elements (only for trivially copyable types)
+        void assignBytes(const void* source, std::size_t count) noexcept;
+
         template<std::default_initializable T>
         [[nodiscard]] T& get(std::size_t index) noexcept {
             assert(sizeof(T) == mElementSize);
@@ -110,6 +132,10 @@ namespace c2k {
          * Because of the type erasure you can never be 100 % sure though! */
             assert(sizeof(element) == mElementSize);
             assert(alignof(T) == mElementAlignment);
+            if constexpr (std::is_empty_v<T>) {
+                ++mSize;
+                return;
+            }
             if (mSize == mCapacity) {
                 grow();
             }
@@ -124,6 +150,10 @@ namespace c2k {
              * Because of the type erasure you can never be 100 % sure though! */
             assert(sizeof(element) == mElementSize);
             assert(alignof(T) == mElementAlignment);
+            if constexpr (std::is_empty_v<T>) {
+                ++mSize;
+                return;
+            }
             if (mSize == mCapacity) {
                 grow();
             }
@@ -137,22 +167,35 @@ namespace c2k {
             resize(size() - 1);
         }
 
+        // bufferAlignment can be used to align the whole buffer stricter than a single element, e.g. for SIMD
         template<std::default_initializable T>
-        [[nodiscard]] static TypeErasedVector forType() noexcept {
-            constexpr auto elementSize{ sizeof(T) };
-            constexpr auto elementAlignment{ alignof(T) };
-            const auto defaultConstruct{ [](void* address) { new (address) T{}; } };
-            const auto destructor{ [](void* address) { static_cast<T*>(address)->~T(); } };
-            const auto placementNew{ [](void* address, void* elementToMove) {
-                new (address) T{ std::move(*static_cast<T*>(elementToMove)) };
-            } };
-            const auto swapFunc{ [](void* lhs, void* rhs) {
-                using std::swap;
-                swap(*static_cast<T*>(lhs), *static_cast<T*>(rhs));
-            } };
-            return TypeErasedVector{
-                elementSize, elementAlignment, defaultConstruct, destructor, placementNew, swapFunc
+        [[nodiscard]] static TypeErasedVector forType(std::size_t bufferAlignment = alignof(T)) noexcept {
+            static constexpr ElementOperations operations{
+                .defaultConstruct{ [](void* address) { new (address) T{}; } },
+                .destruct{ [](void* address) { static_cast<T*>(address)->~T(); } },
+                .moveConstruct{ [](void* address, void* elementToMove) {
+                    new (address) T{ std::move(*static_cast<T*>(elementToMove)) };
+                } },
+                .swap{ [](void* lhs, void* rhs) {
+                    using std::swap;
+                    swap(*static_cast<T*>(lhs), *static_cast<T*>(rhs));
+                } },
+                .isTriviallyRelocatable{ std::is_trivially_copyable_v<T> },
+                .isTriviallyDestructible{ std::is_trivially_destructible_v<T> },
             };
+            if constexpr (std::is_empty_v<T>) {
+                return TypeErasedVector{ sizeof(T), alignof(T), bufferAlignment, &operations, &emptyInstance<T>() };
+            } else {
+                return TypeErasedVector{ sizeof(T), alignof(T), bufferAlignment, &operations };
+            }
+        }
+
+        // all elements of an empty type are represented by this single instance
+        template<typename T>
+        requires std::is_empty_v<T>
+        [[nodiscard]] static T& emptyInstance() noexcept {
+            static T instance{};
+            return instance;
         }
 
         [[nodiscard]] std::size_t capacity() const noexcept {
@@ -161,23 +204,46 @@ namespace c2k {
         [[nodiscard]] std::size_t size() const noexcept {
             return mSize;
         }
+        [[nodiscard]] std::size_t elementSizePadded() const noexcept {
+            return mElementSizePadded;
+        }
+        // true for empty types (e.g. tags), which never allocate any element storage
+        [[nodiscard]] bool isZeroSized() const noexcept {
+            return mElementSizePadded == 0;
+        }
 
         void reserve(std::size_t capacity) noexcept {
             // TODO: maybe don't only use powers of 2
-            while (mCapacity < capacity) {
-                grow();
+            if (mCapacity >= capacity) {
+                return;
+            }
+            auto newCapacity = std::max(mCapacity, std::size_t{ 1 });
+            while (newCapacity < capacity) {
+                newCapacity *= 2;
             }
+            reallocate(newCapacity);
         }
 
+    private:
+        struct ElementOperations {
+            void (*defaultConstruct)(void* address);
+            void (*destruct)(void* address);
+            void (*moveConstruct)(void* address, void* elementToMove);
+            void (*swap)(void* lhs, void* rhs);
+            bool isTriviallyRelocatable;// elements can be moved around via memcpy
+            bool isTriviallyDestructible;
+        };
+
     private:
         TypeErasedVector(std::size_t elementSize,
                          std::size_t elementAlignment,
-                         std::function<void(void*)> defaultConstruct,
-                         std::function<void(void*)> destructor,
-                         std::function<void(void*, void*)> placementNew,
-                         std::function<void(void*, void*)> swap) noexcept;
+                         std::size_t bufferAlignment,
+                         const ElementOperations* operations,
+                         void* sharedElement = nullptr) noexcept;
 
         void grow() noexcept;
+        void reallocate(std::size_t newCapacity) noexcept;
+        void destroyRange(std::size_t first, std::size_t last) noexcept;
 
     private:
         std::size_t mSize{ 0 };
@@ -186,10 +252,8 @@ namespace c2k {
         const std::size_t mElementSize;
         const std::size_t mElementAlignment;
         const std::size_t mElementSizePadded;// includes padding to fulfill alignment requirements
-        const std::function<void(void*)> mDefaultConstruct;
-        const std::function<void(void*)> mDestructor;
-        const std::function<void(void*, void*)> mPlacementNew;
-        const std::function<void(void*, void*)> mSwap;
+        const std::size_t mBufferAlignment;
+        const ElementOperations* const mOperations;
     };
 
 }// namespace c2k
\ No newline at end of file
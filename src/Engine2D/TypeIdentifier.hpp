@@ -4,26 +4,95 @@
 
 #pragma once
 
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+
 namespace c2k {
 
+    template<typename... Types>
+    struct TypeList {
+        static constexpr std::size_t size = sizeof...(Types);
+
+        template<typename Type>
+        static constexpr bool contains = (std::is_same_v<Type, Types> || ...);
+
+        template<typename Type>
+        requires contains<Type>
+        static constexpr std::size_t indexOf = [] {
+            std::size_t index{ 0 };
+            static_cast<void>((... && (!std::is_same_v<Type, Types> && (++index, true))));
+            return index;
+        }();
+    };
+
+    /* Specialize this to give a type a fixed dense identifier that is a compile time constant. A whole
+     * TypeList can be registered at once by using a constrained partial specialization (see Component.hpp). */
+    template<typename Type>
+    struct RegisteredTypeIdentifier { };
+
+    template<typename Type>
+    concept HasRegisteredIdentifier = requires {
+        { RegisteredTypeIdentifier<Type>::value } -> std::convertible_to<std::size_t>;
+    };
+
     class TypeIdentifier final {
     public:
         using UnderlyingType = std::size_t;
 
+        // identifiers below this value are reserved for registered types, all other types are numbered on first use
+        static constexpr UnderlyingType numRegisteredIdentifiers = 16;
+
     public:
         template<typename Type>
-        [[nodiscard]] static UnderlyingType get() {
-            const static UnderlyingType id{ getNext() };
-            return id;
+        [[nodiscard]] static UnderlyingType get() noexcept {
+            if constexpr (HasRegisteredIdentifier<Type>) {
+                static_assert(RegisteredTypeIdentifier<Type>::value < numRegisteredIdentifiers,
+                              "Registered type identifiers must be below numRegisteredIdentifiers.");
+                return RegisteredTypeIdentifier<Type>::value;
+            } else {
+                const static UnderlyingType id{ getNext() };
+                return id;
+            }
+        }
+
+        // the name of the type as reported by the compiler
+        template<typename Type>
+        [[nodiscard]] static constexpr std::string_view name() noexcept {
+#if defined(_MSC_VER) && !defined(__clang__)
+            constexpr std::string_view functionName{ __FUNCSIG__ };
+            constexpr auto first = functionName.find("name<") + 5;
+            constexpr auto last = functionName.rfind(">(void)");
+#else
+            constexpr std::string_view functionName{ __PRETTY_FUNCTION__ };
+            constexpr auto first = functionName.find("Type = ") + 7;
+            constexpr auto last = functionName.find_first_of(";]", first);
+#endif
+            return functionName.substr(first, last - first);
+        }
+
+        /* Unlike the dense identifiers, the hash of a type doesn't depend on the order of first use. It stays
+         * the same across runs and builds as long as the type name and the compiler don't change. */
+        template<typename Type>
+        [[nodiscard]] static constexpr std::uint64_t hash() noexcept {
+            std::uint64_t result{ 0xcbf29ce484222325 };// FNV-1a
+            for (const char c : name<Type>()) {
+                result ^= static_cast<std::uint64_t>(static_cast<unsigned char>(c));
+                result *= 1099511628211;
+            }
+            return result;
         }
 
     private:
-        [[nodiscard]] static UnderlyingType getNext() {
+        [[nodiscard]] static UnderlyingType getNext() noexcept {
             return mNextId++;
         }
 
     private:
-        static inline UnderlyingType mNextId{ 0 };
+        static inline std::atomic<UnderlyingType> mNextId{ numRegisteredIdentifiers };
     };
 
 }// namespace c2k
\ No newline at end of file
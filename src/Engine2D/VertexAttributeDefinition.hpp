@@ -6,6 +6,12 @@
 
 namespace c2k {
 
+    // whether the vertex attributes advance once per vertex or once per drawn instance
+    enum class VertexAttributeRate {
+        PerVertex,
+        PerInstance,
+    };
+
     struct VertexAttributeDefinition {
         VertexAttributeDefinition(GLint count, GLenum type, GLboolean normalized) noexcept
             : count(count),
@@ -31,6 +31,7 @@ namespace c2k {
         swap(mVertexBufferObjectName, other.mVertexBufferObjectName);
         swap(mElementBufferObjectName, other.mElementBufferObjectName);
         swap(mNumIndices, other.mNumIndices);
+        swap(mIndexType, other.mIndexType);
     }
 
     VertexBuffer::~VertexBuffer() {
@@ -45,6 +46,7 @@ namespace c2k {
         swap(mVertexBufferObjectName, other.mVertexBufferObjectName);
         swap(mElementBufferObjectName, other.mElementBufferObjectName);
         swap(mNumIndices, other.mNumIndices);
+        swap(mIndexType, other.mIndexType);
         return *this;
     }
 
@@ -60,6 +62,48 @@ namespace c2k {
         unbindVertexArrayObject();
     }
 
+    void VertexBuffer::setVertexAttributeLayout(std::span<const VertexAttributeDefinition> attributes,
+                                                VertexAttributeRate rate,
+                                                GLsizei stride) const {
+        GLuint location{ 0U };
+        std::uintptr_t offset{ 0U };
+        // calculate stride (unless it includes padding and has therefore been given explicitly)
+        if (stride == 0) {
+            std::for_each(attributes.begin(), attributes.end(),
+                          [&stride](const VertexAttributeDefinition& definition) {
+                              stride += gsl::narrow_cast<GLsizei>(GLUtils::getSizeOfGLType(definition.type) *
+                                                                  definition.count);
+                          });
+        }
+
+        // set vertex attributes
+        std::for_each(attributes.begin(), attributes.end(),
+                      [this, &location, &offset, stride](const VertexAttributeDefinition& definition) {
+                          glEnableVertexArrayAttrib(mVertexArrayObjectName, location);
+                          glVertexArrayVertexBuffer(mVertexArrayObjectName, 0, mVertexBufferObjectName, 0, stride);
+                          if (GLUtils::isIntegralType(definition.type) && !definition.normalized) {
+                              glVertexArrayAttribIFormat(mVertexArrayObjectName, location, definition.count,
+                                                         definition.type, gsl::narrow_cast<GLuint>(offset));
+                          } else {
+                              glVertexArrayAttribFormat(mVertexArrayObjectName, location, definition.count,
+                                                        definition.type, definition.normalized,
+                                                        gsl::narrow_cast<GLuint>(offset));
+                          }
+                          glVertexArrayAttribBinding(mVertexArrayObjectName, location, 0);
+                          spdlog::info(
+                                  "Enabled vertex attribute {} (count {}, type {}, normalized {}, stride {}, "
+                                  "offset {})",
+                                  location, definition.count, definition.type, definition.normalized, stride, offset);
+                          ++location;
+                          offset += GLUtils::getSizeOfGLType(definition.type) * definition.count;
+                      });
+        if (rate == VertexAttributeRate::PerInstance) {
+            glVertexArrayBindingDivisor(mVertexArrayObjectName, 0, 1);
+        }
+        // attach index buffer to vertex array object
+        glVertexArrayElementBuffer(mVertexArrayObjectName, mElementBufferObjectName);
+    }
+
     void VertexBuffer::bindVertexArrayObject() const noexcept {
         if (sCurrentlyBoundVertexArrayObjectName != mVertexArrayObjectName) {
             glBindVertexArray(mVertexArrayObjectName);
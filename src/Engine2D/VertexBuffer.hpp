@@ -7,6 +7,8 @@
 #include "VertexAttributeDefinition.hpp"
 #include "GLDataUsagePattern.hpp"
 #include "GlUtils.hpp"
+#include <array>
+#include <span>
 
 namespace c2k {
 
@@ -28,7 +30,15 @@ namespace c2k {
         [[nodiscard]] std::size_t indicesCount() const noexcept {
             return mNumIndices;
         }
+        // GL_UNSIGNED_SHORT or GL_UNSIGNED_INT
+        [[nodiscard]] GLenum indexType() const noexcept {
+            return mIndexType;
+        }
         void setVertexAttributeLayout(std::convertible_to<VertexAttributeDefinition> auto... args) const;
+        // a stride of 0 means that the attributes are tightly packed
+        void setVertexAttributeLayout(std::span<const VertexAttributeDefinition> attributes,
+                                      VertexAttributeRate rate = VertexAttributeRate::PerVertex,
+                                      GLsizei stride = 0) const;
 
         template<typename VertexData>
         void submitVertexData(std::span<VertexData> data) noexcept {
@@ -52,7 +62,8 @@ namespace c2k {
         }
 
         template<typename IndexData>
-        void submitIndexData(std::span<IndexData> data) noexcept {
+        void submitIndexData(std::span<IndexData> data, GLenum indexType = GL_UNSIGNED_INT) noexcept {
+            assert(indexType == GL_UNSIGNED_SHORT || indexType == GL_UNSIGNED_INT);
             const GLsizeiptr size = data.size() * sizeof(typename decltype(data)::value_type);
             if (size > mCurrentIndexBufferSize) {
                 glNamedBufferData(mElementBufferObjectName, size, data.data(), static_cast<GLenum>(mDataUsagePattern));
@@ -60,19 +71,18 @@ namespace c2k {
             } else {
                 glNamedBufferSubData(mElementBufferObjectName, 0, size, data.data());
             }
-            // TODO: handle the possibility of varying data type for OpenGL indices
-            static_assert(sizeof(IndexData::i0) == 4);
-            mNumIndices = data.size() * sizeof(typename decltype(data)::value_type) / sizeof(IndexData::i0);
+            mNumIndices = static_cast<std::size_t>(size) / GLUtils::getSizeOfGLType(indexType);
+            mIndexType = indexType;
         }
 
         template<typename IndexData>
-        void submitIndexData(IndexData&& data) noexcept {
-            submitIndexData(std::span{ std::forward<IndexData>(data) });
+        void submitIndexData(IndexData&& data, GLenum indexType = GL_UNSIGNED_INT) noexcept {
+            submitIndexData(std::span{ std::forward<IndexData>(data) }, indexType);
         }
 
         template<typename Iterator>
-        void submitIndexData(Iterator begin, Iterator end) noexcept {
-            submitIndexData(std::span{ begin, end });
+        void submitIndexData(Iterator begin, Iterator end, GLenum indexType = GL_UNSIGNED_INT) noexcept {
+            submitIndexData(std::span{ begin, end }, indexType);
         }
 
     private:
@@ -91,44 +101,15 @@ namespace c2k {
         GLuint mVertexBufferObjectName{ 0U };
         GLuint mElementBufferObjectName{ 0U };
         std::size_t mNumIndices{ 0U };
+        GLenum mIndexType{ GL_UNSIGNED_INT };
         GLsizeiptr mCurrentVertexBufferSize{ 0LL };
         GLsizeiptr mCurrentIndexBufferSize{ 0LL };
         GLDataUsagePattern mDataUsagePattern;
     };
 
     void VertexBuffer::setVertexAttributeLayout(std::convertible_to<VertexAttributeDefinition> auto... args) const {
-        const auto values = { args... };
-        GLuint location{ 0U };
-        std::uintptr_t offset{ 0U };
-        GLsizei stride{ 0 };
-        // calculate stride
-        std::for_each(values.begin(), values.end(), [&stride](const VertexAttributeDefinition& definition) {
-            stride += gsl::narrow_cast<GLsizei>(GLUtils::getSizeOfGLType(definition.type) * definition.count);
-        });
-
-        // set vertex attributes
-        std::for_each(values.begin(), values.end(),
-                      [this, &location, &offset, stride](const VertexAttributeDefinition& definition) {
-                          glEnableVertexArrayAttrib(mVertexArrayObjectName, location);
-                          glVertexArrayVertexBuffer(mVertexArrayObjectName, 0, mVertexBufferObjectName, 0, stride);
-                          if (GLUtils::isIntegralType(definition.type)) {
-                              glVertexArrayAttribIFormat(mVertexArrayObjectName, location, definition.count,
-                                                         definition.type, gsl::narrow_cast<GLuint>(offset));
-                          } else {
-                              glVertexArrayAttribFormat(mVertexArrayObjectName, location, definition.count,
-                                                        definition.type, definition.normalized,
-                                                        gsl::narrow_cast<GLuint>(offset));
-                          }
-                          glVertexArrayAttribBinding(mVertexArrayObjectName, location, 0);
-                          spdlog::info(
-                                  "Enabled vertex attribute {} (count {}, type {}, normalized {}, stride {}, "
-                                  "offset {})",
-                                  location, definition.count, definition.type, definition.normalized, stride, offset);
-                          ++location;
-                          offset += GLUtils::getSizeOfGLType(definition.type) * definition.count;
-                      });
-        // attach index buffer to vertex array object
-        glVertexArrayElementBuffer(mVertexArrayObjectName, mElementBufferObjectName);
+        const std::array<VertexAttributeDefinition, sizeof...(args)> attributes{ args... };
+        setVertexAttributeLayout(attributes);
     }
 
 }// namespace c2k
\ No newline at end of file
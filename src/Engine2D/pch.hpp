@@ -28,7 +28,6 @@
 #include <array>
 #include <chrono>
 #include <concepts>
-#include <execution>
 #include <filesystem>
 #include <functional>
 #include <fstream>
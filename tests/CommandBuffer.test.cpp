@@ -0,0 +1,96 @@
+//
+// Created by coder2k on 06.12.2021.
+//
+
+#include <CommandBuffer.hpp>
+#include <Registry.hpp>
+#include <gtest/gtest.h>
+#include <range/v3/all.hpp>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace c2k;
+
+namespace {
+    struct Counter {
+        int value;
+    };
+
+    struct Label {
+        std::shared_ptr<int> text;// non trivial payload
+    };
+}// namespace
+
+TEST(CommandBufferTests, RecordAndPlayback) {
+    Registry registry;
+    CommandBuffers commandBuffers;
+    const auto existing = registry.createEntity(Counter{ 1 });
+    const auto doomed = registry.createEntity(Counter{ 2 });
+
+    auto& commands = commandBuffers.local();
+    ASSERT_EQ(&commands, &commandBuffers.local());
+    commands.createEntity(Counter{ 3 }, Label{ std::make_shared<int>(42) });
+    commands.attachComponent(existing, Label{ std::make_shared<int>(7) });
+    commands.removeComponent<Counter>(existing);
+    commands.destroyEntity(doomed);
+    commands.destroyEntity(doomed);// destroying twice is fine
+    ASSERT_EQ(commandBuffers.numCommands(), 5);
+    ASSERT_EQ(registry.numEntitiesAlive(), 2);
+
+    commandBuffers.playback(registry);
+    ASSERT_EQ(commandBuffers.numCommands(), 0);
+    ASSERT_EQ(registry.numEntitiesAlive(), 2);
+    ASSERT_FALSE(registry.isEntityAlive(doomed));
+    ASSERT_FALSE(registry.hasComponent<Counter>(existing));
+    ASSERT_EQ(*registry.component<Label>(existing)->text, 7);
+    std::vector<int> counters;
+    for (auto&& [entity, counter, label] : registry.components<Counter, Label>()) {
+        counters.push_back(counter.value);
+        ASSERT_EQ(*label.text, 42);
+    }
+    ASSERT_EQ(counters, (std::vector{ 3 }));
+}
+
+TEST(CommandBufferTests, PerThreadBuffersArePlayedBackBySortKey) {
+    Registry registry;
+    CommandBuffers commandBuffers;
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; ++i) {
+        threads.emplace_back([&commandBuffers, i] {
+            auto& commands = commandBuffers.local();
+            for (int j = 0; j < 100; ++j) {
+                const auto value = j * 4 + i;
+                commands.setSortKey(static_cast<std::uint64_t>(value));
+                commands.createEntity(Counter{ value });
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    ASSERT_EQ(commandBuffers.numCommands(), 400);
+    commandBuffers.playback(registry);
+    int expected = 0;
+    for (auto&& [entity, counter] : registry.components<Counter>()) {
+        ASSERT_EQ(counter.value, expected++);
+    }
+    ASSERT_EQ(expected, 400);
+}
+
+TEST(CommandBufferTests, ClearDestroysPayloads) {
+    const auto payload = std::make_shared<int>(1);
+    {
+        CommandBuffer commands;
+        for (int i = 0; i < 10000; ++i) {// spans multiple blocks of the arena
+            commands.attachComponent(Entity{ 0 }, Label{ payload });
+        }
+        ASSERT_EQ(payload.use_count(), 10001);
+        commands.clear();
+        ASSERT_EQ(payload.use_count(), 1);
+        ASSERT_TRUE(commands.empty());
+        commands.createEntity(Label{ payload });
+        ASSERT_EQ(payload.use_count(), 2);
+    }
+    ASSERT_EQ(payload.use_count(), 1);
+}
@@ -9,6 +9,7 @@
 #include <gtest/gtest.h>
 #include <range/v3/all.hpp>
 #include <gsl/gsl>
+#include <algorithm>
 #include <array>
 #include <iterator>
 #include <new>
@@ -168,4 +169,63 @@ TEST(ComponentHolderTests, TypeErasedIterating_Range_Mutable) {
             ++count;
         }
     }
-}
\ No newline at end of file
+}
+
+TEST(ComponentHolderTests, OwningGroup_PacksMatchingEntitiesAtTheFront) {
+    ComponentHolder<Entity> componentHolder(100);
+    for (auto i : ranges::views::ints(0, 10)) {
+        componentHolder.attach(gsl::narrow_cast<Entity>(i), Health{ 100 + i });
+        if (i % 3 == 0) {
+            componentHolder.attach(gsl::narrow_cast<Entity>(i), Mana{ 500 + i });
+        }
+    }
+    componentHolder.registerGroup<Health, Mana>();
+    ASSERT_EQ((componentHolder.groupSize<Health, Mana>()), 4);
+
+    componentHolder.attach(Entity{ 4 }, Mana{ 504 });
+    ASSERT_EQ((componentHolder.groupSize<Health, Mana>()), 5);
+    componentHolder.remove<Health>(Entity{ 3 });
+    ASSERT_EQ((componentHolder.groupSize<Health, Mana>()), 4);
+    componentHolder.attach(Entity{ 42 }, Mana{ 542 });
+    ASSERT_EQ((componentHolder.groupSize<Health, Mana>()), 4);
+
+    std::vector<Entity> visited;
+    for (auto&& [entity, health, mana] : componentHolder.groupMutable<Health, Mana>()) {
+        ASSERT_EQ(health.value, 100 + static_cast<int>(entity));
+        ASSERT_EQ(mana.value, 500 + static_cast<int>(entity));
+        health.value += 1000;
+        visited.push_back(entity);
+    }
+    std::sort(visited.begin(), visited.end());
+    ASSERT_EQ(visited, (std::vector<Entity>{ 0, 4, 6, 9 }));
+    for (const auto entity : visited) {
+        ASSERT_EQ(componentHolder.get<Health>(entity).value, 1100 + static_cast<int>(entity));
+    }
+    ASSERT_EQ(componentHolder.get<Health>(Entity{ 5 }).value, 105);
+
+    componentHolder.removeAll(Entity{ 6 });
+    ASSERT_FALSE(componentHolder.has<Health>(Entity{ 6 }));
+    ASSERT_FALSE(componentHolder.has<Mana>(Entity{ 6 }));
+    ASSERT_EQ(ranges::distance(componentHolder.group<Health, Mana>()), 3);
+}
+
+TEST(ComponentHolderTests, TypeErasedIterating_Range_SmallestSetDrivesIteration) {
+    ComponentHolder<Entity> componentHolder(100);
+    for (auto i : ranges::views::ints(0, 50)) {
+        componentHolder.attach(gsl::narrow_cast<Entity>(i), Health{ 100 + i });
+    }
+    componentHolder.attach(Entity{ 42 }, Mana{ 542 });
+    componentHolder.attach(Entity{ 7 }, Mana{ 507 });
+    componentHolder.attach(Entity{ 77 }, Mana{ 577 });
+    const std::array<std::size_t, 2> typeIdentifiers{ componentHolder.typeIdentifier<Health>(),
+                                                      componentHolder.typeIdentifier<Mana>() };
+    auto&& [begin, end] = componentHolder.getTypeErased(typeIdentifiers.cbegin(), typeIdentifiers.cend());
+    std::vector<std::size_t> visited;
+    for (auto it{ begin }; it != end; ++it) {
+        const auto pair = *it;
+        ASSERT_EQ(static_cast<const Health*>(pair.get(0))->value + 400, static_cast<const Mana*>(pair.get(1))->value);
+        visited.push_back(pair.index());
+    }
+    // Mana has fewer instances, so its insertion order is used
+    ASSERT_EQ(visited, (std::vector<std::size_t>{ 42, 7 }));
+}
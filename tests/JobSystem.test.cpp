@@ -0,0 +1,184 @@
+//
+// Created by coder2k on 04.12.2021.
+//
+
+#include <JobSystem.hpp>
+#include <SystemScheduler.hpp>
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace c2k;
+
+namespace {
+    struct Health {
+        int value;
+    };
+
+    struct Armor {
+        int value;
+    };
+
+    struct Poison { };
+
+    // spins until the flag is set or the timeout is reached
+    [[nodiscard]] bool waitFor(const std::atomic<bool>& flag) {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{ 5 };
+        while (!flag.load() && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::yield();
+        }
+        return flag.load();
+    }
+}// namespace
+
+TEST(JobSystemTests, RunsAllJobs) {
+    JobSystem jobSystem{ 4 };
+    JobCounter counter{ 0 };
+    std::atomic<int> sum{ 0 };
+    for (int i = 1; i <= 1000; ++i) {
+        jobSystem.schedule([&sum, i] { sum += i; }, counter);
+    }
+    jobSystem.wait(counter);
+    ASSERT_EQ(counter.load(), 0);
+    ASSERT_EQ(sum.load(), 500500);
+}
+
+TEST(JobSystemTests, JobsCanScheduleJobs) {
+    JobSystem jobSystem{ 2 };
+    JobCounter counter{ 0 };
+    std::atomic<int> numExecutedJobs{ 0 };
+    for (int i = 0; i < 10; ++i) {
+        jobSystem.schedule(
+                [&] {
+                    for (int j = 0; j < 10; ++j) {
+                        jobSystem.schedule([&] { ++numExecutedJobs; }, counter);
+                    }
+                    ++numExecutedJobs;
+                },
+                counter);
+    }
+    jobSystem.wait(counter);
+    ASSERT_EQ(numExecutedJobs.load(), 110);
+}
+
+TEST(JobSystemTests, WorksWithoutWorkers) {
+    JobSystem jobSystem{ 0 };
+    JobCounter counter{ 0 };
+    int value = 0;
+    jobSystem.schedule([&value] { value = 42; }, counter);
+    jobSystem.wait(counter);
+    ASSERT_EQ(value, 42);
+}
+
+TEST(JobSystemTests, WaitUntilSleepsUntilNotified) {
+    JobSystem jobSystem{ 1 };
+    std::atomic<bool> isDone{ false };
+    std::jthread thread{ [&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds{ 10 });
+        isDone = true;
+        jobSystem.notifyWaitingThreads();
+    } };
+    jobSystem.waitUntil([&isDone] { return isDone.load(); });
+    ASSERT_TRUE(isDone.load());
+}
+
+TEST(JobSystemTests, ParallelEachRunsChunksAsJobs) {
+    JobSystem jobSystem{ 3 };
+    Registry registry;
+    registry.setJobSystem(&jobSystem);
+    for (int i = 0; i < 10000; ++i) {
+        const auto entity = registry.createEntity(Health{ i });
+        if (i % 2 == 0) {
+            registry.attachComponent(entity, Armor{ 1 });
+        }
+    }
+    // parallelEach() may be called from within a job as well, the waiting worker helps with the chunks
+    JobCounter counter{ 0 };
+    jobSystem.schedule(
+            [&registry] {
+                registry.parallelEach<Health, Armor>(
+                        [](Entity, Health& health, const Armor& armor) { health.value += armor.value; }, 64);
+            },
+            counter);
+    jobSystem.wait(counter);
+    int index = 0;
+    for (auto&& [entity, health] : registry.components<Health>()) {
+        ASSERT_EQ(health.value, index % 2 == 0 ? index + 1 : index);
+        ++index;
+    }
+    ASSERT_EQ(index, 10000);
+}
+
+TEST(SystemSchedulerTests, ConflictDetection) {
+    const auto healthWriter = SystemAccess{}.writes<Health>();
+    const auto healthReader = SystemAccess{}.reads<Health>();
+    const auto armorWriter = SystemAccess{}.writes<Armor>().reads<Health>();
+    ASSERT_TRUE(healthWriter.conflictsWith(healthReader));
+    ASSERT_TRUE(healthReader.conflictsWith(healthWriter));
+    ASSERT_FALSE(healthReader.conflictsWith(healthReader));
+    ASSERT_FALSE(healthReader.conflictsWith(armorWriter));
+    ASSERT_TRUE(healthWriter.conflictsWith(armorWriter));
+    ASSERT_TRUE(healthReader.conflictsWith(SystemAccess{}.exclusive()));
+
+    // disjoint entity sets never conflict
+    const auto poisonedHealthWriter = SystemAccess{}.writes<Health>().with<Health, Poison>();
+    const auto healthyHealthWriter = SystemAccess{}.writes<Health>().with<Health>().without<Poison>();
+    ASSERT_FALSE(poisonedHealthWriter.conflictsWith(healthyHealthWriter));
+    // ...unless one of them accesses the component on other entities as well
+    const auto anyHealthWriter = SystemAccess{}.writes<Health>().with<Armor>().without<Poison>();
+    ASSERT_TRUE(poisonedHealthWriter.conflictsWith(anyHealthWriter));
+}
+
+TEST(SystemSchedulerTests, ConflictingSystemsRunInOrder) {
+    JobSystem jobSystem{ 3 };
+    SystemScheduler scheduler{ jobSystem };
+    std::mutex mutex;
+    std::vector<int> order;
+    const auto record = [&](int value) {
+        return [&, value] {
+            std::scoped_lock lock{ mutex };
+            order.push_back(value);
+        };
+    };
+    const auto mainThread = std::this_thread::get_id();
+    std::thread::id exclusiveThread;
+    scheduler.addSystem("first", SystemAccess{}.writes<Health>(), record(0));
+    scheduler.addSystem("second", SystemAccess{}.reads<Health>().writes<Armor>(), record(1));
+    scheduler.addSystem("third", SystemAccess{}.exclusive(), [&] {
+        exclusiveThread = std::this_thread::get_id();
+        record(2)();
+    });
+    scheduler.addSystem("fourth", SystemAccess{}.reads<Armor>(), record(3));
+    for (int i = 0; i < 10; ++i) {
+        order.clear();
+        scheduler.run();
+        ASSERT_EQ(order, (std::vector{ 0, 1, 2, 3 }));
+        ASSERT_EQ(exclusiveThread, mainThread);
+    }
+    ASSERT_EQ(scheduler.timings().size(), 4);
+    ASSERT_EQ(scheduler.timings()[2].name, "third");
+    ASSERT_EQ(scheduler.timings()[2].numRuns, 10);
+}
+
+TEST(SystemSchedulerTests, NonConflictingSystemsRunConcurrently) {
+    JobSystem jobSystem{ 2 };
+    SystemScheduler scheduler{ jobSystem };
+    std::atomic<bool> firstStarted{ false };
+    std::atomic<bool> secondStarted{ false };
+    bool firstSawSecond = false;
+    bool secondSawFirst = false;
+    scheduler.addSystem("first", SystemAccess{}.writes<Health>(), [&] {
+        firstStarted = true;
+        firstSawSecond = waitFor(secondStarted);
+    });
+    scheduler.addSystem("second", SystemAccess{}.writes<Armor>(), [&] {
+        secondStarted = true;
+        secondSawFirst = waitFor(firstStarted);
+    });
+    scheduler.run();
+    ASSERT_TRUE(firstSawSecond);
+    ASSERT_TRUE(secondSawFirst);
+}
@@ -0,0 +1,56 @@
+//
+// Created by coder2k on 13.12.2021.
+//
+
+#include <QuadVertexKernel.hpp>
+#include <gtest/gtest.h>
+#include <array>
+#include <vector>
+
+using namespace c2k;
+
+// 13 quads cover the AVX2 (8 quads), SSE2 (4 quads) and scalar (1 quad) code paths
+TEST(QuadVertexKernelTests, GeneratedVertices_MatchTheTransformedUnitQuad) {
+    constexpr std::size_t numQuads = 13;
+    QuadBatch quads{ numQuads };
+    std::vector<glm::mat4> transforms;
+    std::vector<Rect> textureRects;
+    for (std::size_t i = 0; i < numQuads; ++i) {
+        const auto value = static_cast<float>(i);
+        transforms.push_back(glm::scale(glm::rotate(glm::translate(glm::mat4{ 1.0f },
+                                                                   glm::vec3{ value, 2.0f * value, value / 10.0f }),
+                                                    value, glm::vec3{ 0.0f, 0.0f, 1.0f }),
+                                        glm::vec3{ value + 1.0f, 2.0f, 1.0f }));
+        textureRects.push_back(Rect{ .left{ value / 20.0f },
+                                     .bottom{ value / 30.0f },
+                                     .right{ 1.0f - value / 40.0f },
+                                     .top{ 1.0f - value / 50.0f } });
+        quads.add(transforms.back(), textureRects.back(), 0x01020304U + static_cast<GLuint>(i),
+                  static_cast<GLushort>(i));
+    }
+    std::vector<QuadVertex> vertices(numQuads * 4);
+    generateQuadVertices(quads, vertices);
+
+    constexpr std::array<glm::vec4, 4> corners{ glm::vec4{ -1.0f, -1.0f, 0.0f, 1.0f },
+                                                glm::vec4{ 1.0f, -1.0f, 0.0f, 1.0f },
+                                                glm::vec4{ 1.0f, 1.0f, 0.0f, 1.0f },
+                                                glm::vec4{ -1.0f, 1.0f, 0.0f, 1.0f } };
+    for (std::size_t i = 0; i < numQuads; ++i) {
+        const auto& rect = textureRects[i];
+        const std::array<glm::vec2, 4> texCoords{ glm::vec2{ rect.left, rect.bottom },
+                                                  glm::vec2{ rect.right, rect.bottom },
+                                                  glm::vec2{ rect.right, rect.top },
+                                                  glm::vec2{ rect.left, rect.top } };
+        for (std::size_t corner = 0; corner < 4; ++corner) {
+            const auto& vertex = vertices[i * 4 + corner];
+            const auto expectedPosition = transforms[i] * corners[corner];
+            ASSERT_NEAR(vertex.position.x, expectedPosition.x, 1e-4f);
+            ASSERT_NEAR(vertex.position.y, expectedPosition.y, 1e-4f);
+            ASSERT_NEAR(vertex.position.z, expectedPosition.z, 1e-4f);
+            ASSERT_EQ(vertex.color, 0x01020304U + static_cast<GLuint>(i));
+            ASSERT_EQ(vertex.texCoords, glm::packUnorm2x16(texCoords[corner]));
+            ASSERT_EQ(vertex.texIndex, static_cast<GLushort>(i));
+            ASSERT_EQ(vertex.padding, 0U);
+        }
+    }
+}
@@ -6,14 +6,19 @@
 #include <TypeIdentifier.hpp>
 #include <ComponentHolderPairIterator.hpp>
 #include <Entity.hpp>
+#include <EntityUtils/EntityUtils.hpp>
 #include <gtest/gtest.h>
 #include <range/v3/all.hpp>
 #include <tl/optional.hpp>
 #include <gsl/gsl>
+#include <algorithm>
 #include <array>
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <iterator>
 #include <new>
+#include <span>
 #include <tuple>
 #include <utility>
 #include <vector>
@@ -31,9 +36,9 @@ struct Velocity {
 TEST(RegistryComponentHolderGrowingFixture, TriggerTypeIdentifierCreation_UseInDifferentOrder) {
     Registry registry;
     const auto positionID = registry.typeIdentifier<Position>();
-    ASSERT_EQ(positionID, 0);
+    ASSERT_GE(positionID, TypeIdentifier::numRegisteredIdentifiers);
     const auto velocityID = registry.typeIdentifier<Velocity>();
-    ASSERT_EQ(velocityID, 1);
+    ASSERT_EQ(velocityID, positionID + 1);
     const auto entity = registry.createEntity();
     registry.attachComponent(entity, Velocity{ 1.0f, 2.0f });
     registry.attachComponent(entity, Position{ 3.0f, 4.0f });
@@ -268,4 +273,767 @@ TEST(RegistryTests, TypeErasedIterating) {
         }
         ASSERT_EQ(6, count);
     }
-}
\ No newline at end of file
+}
+
+TEST(RegistryTests, OwningGroup_IterateAndDestroy) {
+    Registry registry;
+    registry.registerGroup<Health, Mana>();
+    std::vector<Entity> entities;
+    for (auto i : ranges::views::ints(0, 8)) {
+        if (i % 2 == 0) {
+            entities.push_back(registry.createEntity(Health{ 100 + i }, Mana{ 500 + i }));
+        } else {
+            entities.push_back(registry.createEntity(Mana{ 500 + i }));
+        }
+    }
+    registry.destroyEntity(entities[2]);
+    int count{ 0 };
+    for (auto&& [entity, health, mana] : registry.group<Health, Mana>()) {
+        ASSERT_TRUE(registry.isEntityAlive(entity));
+        ASSERT_EQ(health.value + 400, mana.value);
+        ++count;
+    }
+    ASSERT_EQ(count, 3);
+}
+
+TEST(RegistryEntityCreationAndDestructionFixture, BulkCreateAndDestroy) {
+    Registry registry;
+    const auto first = registry.createEntities(10, Health{ 1 }, Mana{ 2 });
+    ASSERT_EQ(first.size(), 10);
+    ASSERT_EQ(registry.numEntitiesAlive(), 10);
+    for (const auto entity : first) {
+        ASSERT_EQ(registry.component<Health>(entity)->value, 1);
+        ASSERT_EQ(registry.component<Mana>(entity)->value, 2);
+    }
+    registry.destroyEntities(std::span{ first }.subspan(0, 6));
+    ASSERT_EQ(registry.numEntitiesAlive(), 4);
+    ASSERT_EQ(registry.numEntitiesDead(), 6);
+    ASSERT_EQ(ranges::distance(registry.components<Health>()), 4);
+    for (std::size_t i = 0; i < first.size(); ++i) {
+        ASSERT_EQ(registry.isEntityAlive(first[i]), i >= 6);
+    }
+
+    // recycles the six dead entities and creates two new ones
+    const auto second = registry.createEntities(8, Health{ 3 });
+    ASSERT_EQ(registry.numEntities(), 12);
+    ASSERT_EQ(registry.numEntitiesAlive(), 12);
+    for (const auto entity : second) {
+        ASSERT_EQ(registry.component<Health>(entity)->value, 3);
+        ASSERT_FALSE(registry.hasComponent<Mana>(entity));
+    }
+    ASSERT_EQ(registry.destroyEntitiesWithComponents<Health>(), 12);
+    ASSERT_EQ(registry.numEntitiesAlive(), 0);
+}
+
+TEST(RegistryEntityCreationAndDestructionFixture, BulkDestroy_UnparentsSurvivingChildren) {
+    Registry registry;
+    const auto parent = registry.createEntity(TransformComponent{}, RootComponent{});
+    const auto destroyedChild = registry.createEntity(TransformComponent{}, RelationshipComponent{ parent });
+    const auto survivingChild = registry.createEntity(TransformComponent{}, RelationshipComponent{ parent });
+    const std::array toDestroy{ parent, destroyedChild };
+    registry.destroyEntities(toDestroy);
+    ASSERT_FALSE(registry.isEntityAlive(parent));
+    ASSERT_FALSE(registry.isEntityAlive(destroyedChild));
+    ASSERT_TRUE(registry.isEntityAlive(survivingChild));
+    ASSERT_FALSE(registry.hasComponent<RelationshipComponent>(survivingChild));
+    ASSERT_TRUE(registry.hasComponent<RootComponent>(survivingChild));
+}
+
+TEST(RegistryEntityCreationAndDestructionFixture, BulkDestroy_DuplicatesAreDestroyedOnce) {
+    Registry registry;
+    const auto first = registry.createEntity(Health{ 1 });
+    const auto second = registry.createEntity();
+    const auto survivor = registry.createEntity(Health{ 3 });
+    const std::array toDestroy{ first, second, first, second };
+    registry.destroyEntities(toDestroy);
+    ASSERT_EQ(registry.numEntitiesDead(), 2);
+    ASSERT_EQ(registry.numEntitiesAlive(), 1);
+
+    // the free list only contains both identifiers once
+    const auto recycled = registry.createEntities(3);
+    ASSERT_EQ(registry.numEntities(), 4);
+    ASSERT_NE(Registry::getIdentifierBitsFromEntity(recycled[0]), Registry::getIdentifierBitsFromEntity(recycled[1]));
+    ASSERT_EQ(Registry::getIdentifierBitsFromEntity(recycled[2]), 3);
+    ASSERT_TRUE(registry.isEntityAlive(survivor));
+    ASSERT_EQ(ranges::distance(registry.components<Health>()), 1);
+}
+
+TEST(RegistryEntityCreationAndDestructionFixture, BulkDestroy_KeepsGroupsAndQueriesConsistent) {
+    Registry registry;
+    registry.registerGroup<Health, Mana>();
+    const auto query = registry.registerQuery<Health>(Without<Mana>{});
+    const auto withMana = registry.createEntities(100, Health{ 1 }, Mana{ 2 });
+    const auto withoutMana = registry.createEntities(50, Health{ 3 });
+    ASSERT_EQ(ranges::distance(registry.group<Health, Mana>()), 100);
+    ASSERT_EQ(registry.numMatches(query), 50);
+
+    // every other entity, which is enough to remove them by compacting the storages
+    std::vector<Entity> toDestroy;
+    for (std::size_t i = 0; i < withMana.size(); i += 2) {
+        toDestroy.push_back(withMana[i]);
+    }
+    for (std::size_t i = 0; i < withoutMana.size(); i += 2) {
+        toDestroy.push_back(withoutMana[i]);
+    }
+    registry.destroyEntities(toDestroy);
+    ASSERT_EQ(ranges::distance(registry.components<Health>()), 75);
+    ASSERT_EQ(ranges::distance(registry.group<Health, Mana>()), 50);
+    for (auto&& [entity, health, mana] : registry.group<Health, Mana>()) {
+        ASSERT_TRUE(registry.isEntityAlive(entity));
+        ASSERT_EQ(health.value, 1);
+        ASSERT_EQ(mana.value, 2);
+    }
+    ASSERT_EQ(registry.numMatches(query), 25);
+    for (auto&& [entity, health] : registry.queryMutable(query)) {
+        ASSERT_TRUE(registry.isEntityAlive(entity));
+        ASSERT_EQ(health.value, 3);
+    }
+}
+
+TEST(RegistryTests, ComponentSignature) {
+    Registry registry;
+    const auto entity = registry.createEntity(Health{ 1 });
+    const auto other = registry.createEntity(Mana{ 2 });
+    const auto healthBit = registry.typeIdentifier<Health>();
+    const auto manaBit = registry.typeIdentifier<Mana>();
+    ASSERT_TRUE(registry.componentSignature(entity).test(healthBit));
+    ASSERT_FALSE(registry.componentSignature(entity).test(manaBit));
+    registry.attachComponent(entity, Mana{ 3 });
+    ASSERT_EQ(registry.componentSignature(entity).count(), 2);
+    registry.removeComponent<Health>(entity);
+    ASSERT_FALSE(registry.hasComponent<Health>(entity));
+    ASSERT_TRUE(registry.hasComponent<Mana>(entity));
+    registry.destroyEntity(entity);
+    ASSERT_EQ(ranges::distance(registry.components<Mana>()), 1);
+    const auto recycled = registry.createEntity();
+    ASSERT_TRUE(registry.componentSignature(recycled).none());
+    ASSERT_FALSE(registry.hasComponent<Mana>(recycled));
+    ASSERT_TRUE(registry.hasComponent<Mana>(other));
+}
+
+template<std::size_t index>
+struct NumberedComponent {
+    std::size_t value;
+};
+
+TEST(RegistryTests, ComponentSignature_SupportsMoreThan64ComponentTypes) {
+    static constexpr std::size_t numTypes = 80;
+    using LastComponent = NumberedComponent<numTypes - 1>;
+    Registry registry;
+    const auto entity = registry.createEntity();
+    const auto other = registry.createEntity(Health{ 1 });
+    [&]<std::size_t... indices>(std::index_sequence<indices...>) {
+        (registry.attachComponent(entity, NumberedComponent<indices>{ indices }), ...);
+        ASSERT_TRUE((registry.hasComponent<NumberedComponent<indices>>(entity) && ...));
+        ASSERT_FALSE((registry.hasComponent<NumberedComponent<indices>>(other) || ...));
+        ASSERT_TRUE(((registry.component<NumberedComponent<indices>>(entity)->value == indices) && ...));
+    }(std::make_index_sequence<numTypes>{});
+    ASSERT_GE(registry.typeIdentifier<LastComponent>(), 64);
+    ASSERT_EQ(registry.componentSignature(entity).count(), numTypes);
+    const auto query = registry.registerQuery<LastComponent>();
+    ASSERT_EQ(registry.numMatches(query), 1);
+
+    registry.removeComponent<LastComponent>(entity);
+    ASSERT_FALSE(registry.hasComponent<LastComponent>(entity));
+    ASSERT_EQ(registry.numMatches(query), 0);
+    registry.destroyEntity(entity);
+    ASSERT_EQ(ranges::distance(registry.components<NumberedComponent<numTypes - 2>>()), 0);
+    ASSERT_TRUE(registry.hasComponent<Health>(other));
+}
+
+TEST(RegistryTests, Hierarchy_ChildrenAndSubtreeDestruction) {
+    Registry registry;
+    const auto root = registry.createEntity(TransformComponent{}, RootComponent{});
+    const auto child0 = registry.createEntity(TransformComponent{}, RelationshipComponent{ root });
+    const auto child1 = registry.createEntity(TransformComponent{}, RelationshipComponent{ root });
+    const auto grandChild = registry.createEntity(TransformComponent{}, RelationshipComponent{ child0 });
+    const auto unrelated = registry.createEntity(TransformComponent{}, RootComponent{});
+    ASSERT_EQ(registry.children(root), (std::vector<Entity>{ child1, child0 }));
+    ASSERT_EQ(registry.children(child0), (std::vector<Entity>{ grandChild }));
+
+    registry.removeComponent<RelationshipComponent>(child1);
+    ASSERT_EQ(registry.children(root), (std::vector<Entity>{ child0 }));
+    registry.attachComponent(child1, RelationshipComponent{ child0 });
+    ASSERT_EQ(registry.children(child0), (std::vector<Entity>{ child1, grandChild }));
+
+    // destroying a leaf only unlinks it from its own parent
+    registry.destroyEntity(grandChild);
+    ASSERT_EQ(registry.children(child0), (std::vector<Entity>{ child1 }));
+
+    registry.destroySubtree(root);
+    ASSERT_FALSE(registry.isEntityAlive(root));
+    ASSERT_FALSE(registry.isEntityAlive(child0));
+    ASSERT_FALSE(registry.isEntityAlive(child1));
+    ASSERT_TRUE(registry.isEntityAlive(unrelated));
+    ASSERT_EQ(registry.numEntitiesAlive(), 1);
+    ASSERT_EQ(ranges::distance(registry.components<RelationshipComponent>()), 0);
+
+    const auto recycled = registry.createEntity(TransformComponent{});
+    ASSERT_TRUE(registry.children(recycled).empty());
+}
+
+TEST(RegistryTests, Hierarchy_AttachingAnotherRelationshipReparents) {
+    Registry registry;
+    const auto first = registry.createEntity(TransformComponent{}, RootComponent{});
+    const auto second = registry.createEntity(TransformComponent{}, RootComponent{});
+    const auto child = registry.createEntity(TransformComponent{}, RelationshipComponent{ first });
+    const auto sibling = registry.createEntity(TransformComponent{}, RelationshipComponent{ first });
+
+    registry.attachComponent(child, RelationshipComponent{ second });
+    ASSERT_EQ(registry.children(first), (std::vector<Entity>{ sibling }));
+    ASSERT_EQ(registry.children(second), (std::vector<Entity>{ child }));
+    ASSERT_EQ(registry.component<RelationshipComponent>(child)->parent, second);
+
+    // attaching the same parent again doesn't link the entity twice
+    registry.attachComponent(child, RelationshipComponent{ second });
+    ASSERT_EQ(registry.children(second), (std::vector<Entity>{ child }));
+    ASSERT_EQ(ranges::distance(registry.components<RelationshipComponent>()), 2);
+
+    registry.destroySubtree(second);
+    ASSERT_FALSE(registry.isEntityAlive(child));
+    ASSERT_EQ(registry.children(first), (std::vector<Entity>{ sibling }));
+}
+
+TEST(RegistryTests, WorldTransforms_PropagateOnlyChangedSubtrees) {
+    Registry registry;
+    const auto root = registry.createEntity(TransformComponent{ .position{ 1.0f, 0.0f, 0.0f } }, RootComponent{});
+    const auto child = registry.createEntity(TransformComponent{ .position{ 2.0f, 0.0f, 0.0f } },
+                                             RelationshipComponent{ root });
+    const auto unrelated = registry.createEntity(TransformComponent{ .position{ 4.0f, 0.0f, 0.0f } }, RootComponent{});
+    ASSERT_EQ(EntityUtils::updateWorldTransforms(registry), 3);
+    ASSERT_EQ(registry.component<WorldTransformComponent>(root)->matrix[3][0], 1.0f);
+    ASSERT_EQ(registry.component<WorldTransformComponent>(child)->matrix[3][0], 3.0f);
+    ASSERT_EQ(registry.component<WorldTransformComponent>(unrelated)->matrix[3][0], 4.0f);
+    registry.clearChanges();
+
+    // tamper with the cache of the unrelated entity to detect whether it gets recalculated
+    registry.componentMutable<WorldTransformComponent>(unrelated)->matrix[3][1] = 42.0f;
+    registry.componentMutable<TransformComponent>(root)->position.x = 5.0f;
+    ASSERT_EQ(EntityUtils::updateWorldTransforms(registry), 2);
+    ASSERT_EQ(registry.component<WorldTransformComponent>(root)->matrix[3][0], 5.0f);
+    ASSERT_EQ(registry.component<WorldTransformComponent>(child)->matrix[3][0], 7.0f);
+    ASSERT_EQ(registry.component<WorldTransformComponent>(unrelated)->matrix[3][1], 42.0f);
+    registry.clearChanges();
+
+    // reparenting is detected as well
+    registry.removeComponent<RelationshipComponent>(child);
+    registry.attachComponent(child, RelationshipComponent{ unrelated });
+    ASSERT_EQ(EntityUtils::updateWorldTransforms(registry), 1);
+    ASSERT_EQ(registry.component<WorldTransformComponent>(child)->matrix[3][0], 6.0f);
+}
+
+TEST(RegistryTests, WorldTransforms_UnchangedEntitiesAreNotVisited) {
+    Registry registry;
+    const auto root = registry.createEntity(TransformComponent{ .position{ 1.0f, 0.0f, 0.0f } }, RootComponent{});
+    const auto child = registry.createEntity(TransformComponent{ .position{ 2.0f, 0.0f, 0.0f } },
+                                             RelationshipComponent{ root });
+    const auto unrelated = registry.createEntity(TransformComponent{}, RootComponent{});
+    ASSERT_EQ(EntityUtils::updateWorldTransforms(registry), 3);
+    registry.clearChanges();
+
+    ASSERT_EQ(EntityUtils::updateWorldTransforms(registry), 0);
+
+    // only the changed child is visited, its parent and the unrelated entity are not
+    registry.markUpdated<TransformComponent>(child);
+    ASSERT_EQ(EntityUtils::updateWorldTransforms(registry), 1);
+    registry.clearChanges();
+
+    // a parent without transform passes the world transform of its own parent through
+    registry.removeComponent<TransformComponent>(root);
+    ASSERT_EQ(EntityUtils::updateWorldTransforms(registry), 2);
+    ASSERT_FALSE(registry.hasComponent<WorldTransformComponent>(root));
+    ASSERT_EQ(registry.component<WorldTransformComponent>(child)->matrix[3][0], 2.0f);
+    ASSERT_TRUE(registry.hasComponent<WorldTransformComponent>(unrelated));
+}
+
+TEST(RegistryTests, ParallelEach_VisitsEveryMatchingEntityOnce) {
+    Registry registry;
+    for (int i = 0; i < 10000; ++i) {
+        const auto entity = registry.createEntity(Position{ 0.0f, 0.0f });
+        if (i % 3 != 0) {
+            registry.attachComponent(entity, Velocity{ static_cast<float>(i), 0.0f });
+        }
+    }
+    registry.parallelEach<Position, Velocity>(
+            [](Entity, Position& position, const Velocity& velocity) {
+                position.x += velocity.x;
+                position.y += 1.0f;
+            },
+            64);
+    for (auto&& [entity, position] : registry.components<Position>()) {
+        const bool isMoving = registry.hasComponent<Velocity>(entity);
+        ASSERT_EQ(position.y, isMoving ? 1.0f : 0.0f);
+        ASSERT_EQ(position.x, isMoving ? registry.component<Velocity>(entity)->x : 0.0f);
+    }
+}
+
+struct SnapshotAsset {
+    GUID guid{ GUID::create() };
+};
+
+struct SnapshotAssetReference {
+    const SnapshotAsset* asset;
+};
+
+template<>
+struct c2k::AssetReferences<SnapshotAssetReference> {
+    static void forEach(SnapshotAssetReference& component, auto&& function) noexcept {
+        function(component.asset);
+    }
+};
+
+TEST(RegistryTests, Snapshot_RestoreRevertsAllChanges) {
+    Registry registry;
+    registry.registerType<Position>();
+    registry.registerType<Velocity>();
+    const auto first = registry.createEntity(Position{ 1.0f, 2.0f }, Velocity{ 3.0f, 4.0f });
+    const auto second = registry.createEntity(Position{ 5.0f, 6.0f });
+    const auto third = registry.createEntity(Velocity{ 7.0f, 8.0f });
+    registry.destroyEntity(second);
+    const auto snapshot = registry.snapshot();
+
+    registry.componentMutable<Position>(first)->x = 42.0f;
+    registry.destroyEntity(third);
+    const auto fourth = registry.createEntity(Position{ 9.0f, 9.0f });
+    registry.createEntities(100, Velocity{});
+    ASSERT_TRUE(registry.restore(snapshot));
+
+    ASSERT_EQ(registry.numEntities(), 3);
+    ASSERT_EQ(registry.numEntitiesAlive(), 2);
+    ASSERT_TRUE(registry.isEntityAlive(first));
+    ASSERT_TRUE(registry.isEntityAlive(third));
+    ASSERT_FALSE(registry.isEntityAlive(fourth));
+    ASSERT_EQ(registry.component<Position>(first)->x, 1.0f);
+    ASSERT_EQ(registry.component<Velocity>(first)->y, 4.0f);
+    ASSERT_EQ(registry.component<Velocity>(third)->x, 7.0f);
+    ASSERT_FALSE(registry.hasComponent<Position>(third));
+    ASSERT_EQ(ranges::distance(registry.components<Velocity>()), 2);
+
+    // the free list has been restored as well
+    const auto recycled = registry.createEntity();
+    ASSERT_EQ(Registry::getIdentifierBitsFromEntity(recycled), Registry::getIdentifierBitsFromEntity(second));
+    ASSERT_NE(recycled, second);
+}
+
+TEST(RegistryTests, Snapshot_AssetPointersAreResolvedByGUID) {
+    const SnapshotAsset originalAsset;
+    Registry registry;
+    const auto entity = registry.createEntity(SnapshotAssetReference{ &originalAsset });
+    const auto withoutAsset = registry.createEntity(SnapshotAssetReference{ nullptr });
+    const auto snapshot = registry.snapshot();
+
+    const SnapshotAsset reloadedAsset{ originalAsset.guid };
+    Registry otherRegistry;
+    otherRegistry.registerType<SnapshotAssetReference>();
+    ASSERT_TRUE(otherRegistry.restore(snapshot, [&](GUID guid) -> void* {
+        return guid == reloadedAsset.guid ? const_cast<SnapshotAsset*>(&reloadedAsset) : nullptr;
+    }));
+    ASSERT_EQ(otherRegistry.component<SnapshotAssetReference>(entity)->asset, &reloadedAsset);
+    ASSERT_EQ(otherRegistry.component<SnapshotAssetReference>(withoutAsset)->asset, nullptr);
+
+    // without a resolver, the pointers are expected to still be valid
+    ASSERT_TRUE(otherRegistry.restore(snapshot));
+    ASSERT_EQ(otherRegistry.component<SnapshotAssetReference>(entity)->asset, &originalAsset);
+}
+
+struct ProcessLocalReference {
+    const int* value;
+};
+
+template<>
+struct c2k::HasProcessLocalPointers<ProcessLocalReference> : std::true_type { };
+
+TEST(RegistryTests, Snapshot_InvalidSnapshotsAreRejected) {
+    Registry registry;
+    registry.registerType<Position>();
+    registry.registerType<Velocity>();
+    const auto entity = registry.createEntity(Position{ 1.0f, 2.0f });
+    registry.createEntities(3);
+    const auto moving = registry.createEntity(Velocity{ 3.0f, 4.0f });
+    const auto snapshot = registry.snapshot();
+
+    const auto isUntouched = [&] {
+        return registry.numEntities() == 5 && registry.component<Position>(entity)->x == 1.0f &&
+               registry.component<Velocity>(moving)->y == 4.0f;
+    };
+
+    for (std::size_t size = 0; size < snapshot.size(); ++size) {
+        ASSERT_FALSE(registry.restore(std::span{ snapshot }.first(size)));
+        ASSERT_TRUE(isUntouched());
+    }
+
+    // the header starts with the format version followed by the size of the entity handles
+    auto otherVersion = snapshot;
+    otherVersion[0] = std::byte{ 42 };
+    ASSERT_FALSE(registry.restore(otherVersion));
+    auto otherLayout = snapshot;
+    otherLayout[4] = static_cast<std::byte>(sizeof(Entity) == 4 ? 8 : 4);
+    ASSERT_FALSE(registry.restore(otherLayout));
+    ASSERT_TRUE(isUntouched());
+
+    // the storage of Velocity holds a single element with the sparse index 4, which gets replaced by 5
+    std::array<std::byte, 2 * sizeof(std::uint64_t) + sizeof(Registry::Identifier)> pattern{};
+    const std::uint64_t elementSize = sizeof(Velocity);
+    const std::uint64_t count = 1;
+    const Registry::Identifier index = 4;
+    std::memcpy(pattern.data(), &elementSize, sizeof(elementSize));
+    std::memcpy(pattern.data() + sizeof(elementSize), &count, sizeof(count));
+    std::memcpy(pattern.data() + 2 * sizeof(std::uint64_t), &index, sizeof(index));
+    auto invalidIndex = snapshot;
+    const auto position = std::search(invalidIndex.begin(), invalidIndex.end(), pattern.begin(), pattern.end());
+    ASSERT_NE(position, invalidIndex.end());
+    const Registry::Identifier outOfRange = 5;
+    std::memcpy(&*position + 2 * sizeof(std::uint64_t), &outOfRange, sizeof(outOfRange));
+    ASSERT_FALSE(registry.restore(invalidIndex));
+    ASSERT_TRUE(isUntouched());
+
+    // all component types of the snapshot have to be registered
+    Registry otherRegistry;
+    otherRegistry.registerType<Position>();
+    ASSERT_FALSE(otherRegistry.restore(snapshot));
+    otherRegistry.registerType<Velocity>();
+    ASSERT_TRUE(otherRegistry.restore(snapshot));
+    ASSERT_EQ(otherRegistry.component<Velocity>(moving)->x, 3.0f);
+}
+
+TEST(RegistryTests, Snapshot_UnresolvedAssetsAndInvalidAssetIndicesAreRejected) {
+    const SnapshotAsset asset;
+    Registry registry;
+    const auto entity = registry.createEntity(SnapshotAssetReference{ &asset });
+    const auto withoutAsset = registry.createEntity(SnapshotAssetReference{ nullptr });
+    const auto snapshot = registry.snapshot();
+
+    const auto isUntouched = [&] {
+        return registry.component<SnapshotAssetReference>(entity)->asset == &asset &&
+               registry.component<SnapshotAssetReference>(withoutAsset)->asset == nullptr;
+    };
+
+    ASSERT_FALSE(registry.restore(snapshot, [](GUID) -> void* { return nullptr; }));
+    ASSERT_TRUE(isUntouched());
+
+    // the elements hold the index of the only asset and the null sentinel, the index gets replaced by 1
+    const std::array<std::uintptr_t, 2> elements{ 0, std::numeric_limits<std::uintptr_t>::max() };
+    const auto pattern = std::as_bytes(std::span{ elements });
+    auto invalidIndex = snapshot;
+    const auto position = std::find_end(invalidIndex.begin(), invalidIndex.end(), pattern.begin(), pattern.end());
+    ASSERT_NE(position, invalidIndex.end());
+    const std::uintptr_t outOfRange = 1;
+    std::memcpy(&*position, &outOfRange, sizeof(outOfRange));
+    ASSERT_FALSE(registry.restore(invalidIndex));
+    ASSERT_FALSE(registry.restore(invalidIndex, [&](GUID) -> void* { return const_cast<SnapshotAsset*>(&asset); }));
+    ASSERT_TRUE(isUntouched());
+}
+
+TEST(RegistryTests, Snapshot_CorruptedEntitiesAreRejected) {
+    Registry registry;
+    const auto parent = registry.createEntity();
+    const auto child = registry.createEntity(RelationshipComponent{ parent });
+    const auto first = registry.createEntity();
+    const auto second = registry.createEntity();
+    registry.destroyEntity(first);
+    registry.destroyEntity(second);
+    const auto snapshot = registry.snapshot();
+
+    const auto isUntouched = [&] {
+        return registry.numEntitiesAlive() == 2 && registry.firstChild(parent) == child &&
+               registry.component<RelationshipComponent>(child)->parent == parent;
+    };
+
+    // the header (three 32 bit values) and the number of entities are followed by the entity handles, their
+    // hierarchy links (three handles each), the number of recyclable entities and the next recyclable entity
+    constexpr std::size_t numEntities = 4;
+    constexpr auto entityOffset = [](std::size_t index) {
+        return 3 * sizeof(std::uint32_t) + sizeof(std::uint64_t) + index * sizeof(Entity);
+    };
+    constexpr auto linksOffset = [=](std::size_t index) {
+        return entityOffset(numEntities) + index * 3 * sizeof(Entity);
+    };
+    constexpr auto numRecyclableOffset = linksOffset(numEntities);
+    const auto patched = [&](std::size_t offset, const auto& value) {
+        auto result = snapshot;
+        std::memcpy(result.data() + offset, &value, sizeof(value));
+        return result;
+    };
+
+    // an alive handle has to match its slot
+    ASSERT_FALSE(registry.restore(patched(entityOffset(1), parent)));
+    ASSERT_TRUE(isUntouched());
+
+    // hierarchy links must not point outside of the entities or break the sibling lists
+    Registry largerRegistry;
+    const auto outOfRange = largerRegistry.createEntities(numEntities + 1).back();
+    ASSERT_FALSE(registry.restore(patched(linksOffset(0), outOfRange)));
+    ASSERT_FALSE(registry.restore(patched(linksOffset(0), second)));
+    ASSERT_FALSE(registry.restore(patched(linksOffset(1) + 2 * sizeof(Entity), parent)));
+    ASSERT_TRUE(isUntouched());
+
+    /* The slot of the second entity holds the identifier of the first one, whose slot holds an invalid
+     * identifier. Walking one more step runs out of range, making the first slot refer to itself is a cycle. */
+    const std::uint64_t tooManyRecyclable = 3;
+    ASSERT_FALSE(registry.restore(patched(numRecyclableOffset, tooManyRecyclable)));
+    Entity secondSlot;
+    std::memcpy(&secondSlot, snapshot.data() + entityOffset(3), sizeof(secondSlot));
+    auto cyclic = patched(entityOffset(2), secondSlot);
+    std::memcpy(cyclic.data() + numRecyclableOffset, &tooManyRecyclable, sizeof(tooManyRecyclable));
+    ASSERT_FALSE(registry.restore(cyclic));
+    ASSERT_TRUE(isUntouched());
+
+    ASSERT_TRUE(registry.restore(snapshot));
+    ASSERT_TRUE(isUntouched());
+}
+
+TEST(RegistryTests, Snapshot_ProcessLocalPointersCanNotBeResolved) {
+    const int value = 42;
+    Registry registry;
+    const auto entity = registry.createEntity(ProcessLocalReference{ &value });
+    const auto snapshot = registry.snapshot();
+
+    const auto resolveAsset = [](GUID) -> void* { return nullptr; };
+    ASSERT_FALSE(registry.restore(snapshot, resolveAsset));
+    ASSERT_TRUE(registry.restore(snapshot));
+    ASSERT_EQ(registry.component<ProcessLocalReference>(entity)->value, &value);
+
+    // without any components, there is nothing to resolve
+    registry.removeComponent<ProcessLocalReference>(entity);
+    ASSERT_TRUE(registry.restore(registry.snapshot(), resolveAsset));
+}
+
+TEST(RegistryTests, Sort_KeepsOwningGroupsIntactAndFollowsOrder) {
+    Registry registry;
+    registry.registerGroup<Health, Mana>();
+    for (int i = 0; i < 20; ++i) {
+        const auto entity = registry.createEntity(Health{ (i * 7) % 20 }, Position{ static_cast<float>(i), 0.0f });
+        if (i % 3 != 0) {
+            registry.attachComponent(entity, Mana{ 1000 + (i * 7) % 20 });
+        }
+    }
+    registry.sort<Health>([](const Health& lhs, const Health& rhs) { return lhs.value > rhs.value; },
+                          SortAlgorithm::Insertion);
+    int previous = std::numeric_limits<int>::max();
+    int count{ 0 };
+    for (auto&& [entity, health, mana] : registry.group<Health, Mana>()) {
+        ASSERT_LE(health.value, previous);
+        ASSERT_EQ(health.value + 1000, mana.value);
+        previous = health.value;
+        ++count;
+    }
+    ASSERT_EQ(count, 13);
+
+    registry.followOrder<Position, Health>();
+    std::vector<Entity> healthOrder;
+    for (auto&& [entity, health] : registry.components<Health>()) {
+        healthOrder.push_back(entity);
+    }
+    std::vector<Entity> positionOrder;
+    for (auto&& [entity, position] : registry.components<Position>()) {
+        positionOrder.push_back(entity);
+        ASSERT_EQ(registry.component<Health>(entity)->value, (static_cast<int>(position.x) * 7) % 20);
+    }
+    ASSERT_EQ(healthOrder, positionOrder);
+}
+
+TEST(RegistryTests, Each_VisitsMatchingEntitiesWithAndWithoutHandles) {
+    for (const bool useGroup : { false, true }) {
+        Registry registry;
+        if (useGroup) {
+            registry.registerGroup<Health, Mana>();
+        }
+        std::vector<Entity> expected;
+        for (int i = 0; i < 30; ++i) {
+            const auto entity = registry.createEntity(Health{ i });
+            if (i % 3 == 0) {
+                registry.attachComponent(entity, Mana{ 2 * i });
+                expected.push_back(entity);
+            }
+        }
+        std::vector<Entity> visited;
+        registry.each<Health, Mana>([&](Entity entity, const Health& health, Mana& mana) {
+            ASSERT_EQ(registry.component<Health>(entity)->value, health.value);
+            ASSERT_EQ(2 * health.value, mana.value);
+            visited.push_back(entity);
+        });
+        std::sort(visited.begin(), visited.end());
+        ASSERT_EQ(visited, expected);
+        registry.each<Health, Mana>([](const Health& health, Mana& mana) { mana.value += health.value; });
+        for (const auto entity : expected) {
+            ASSERT_EQ(registry.component<Mana>(entity)->value, 3 * registry.component<Health>(entity)->value);
+        }
+    }
+}
+
+TEST(RegistryTests, ChangeTracking_RecordsEachChangeOncePerFrame) {
+    Registry registry;
+    registry.enableChangeTracking<Health>();
+    ASSERT_TRUE(registry.isChangeTrackingEnabled<Health>());
+    ASSERT_FALSE(registry.isChangeTrackingEnabled<Mana>());
+    const auto first = registry.createEntity(Health{ 1 }, Mana{ 1 });
+    const auto second = registry.createEntity(Health{ 2 });
+    registry.attachComponent(registry.createEntity(), Mana{ 3 });
+    registry.patch<Health>(first, [](Health& health) { health.value = 10; });
+    registry.markUpdated<Health>(first);
+    const auto& changes = registry.changes<Health>();
+    ASSERT_EQ(std::vector(changes.added().begin(), changes.added().end()), (std::vector{ first, second }));
+    ASSERT_EQ(std::vector(changes.updated().begin(), changes.updated().end()), std::vector{ first });
+    ASSERT_TRUE(changes.removed().empty());
+    ASSERT_EQ(registry.component<Health>(first)->value, 10);
+
+    registry.clearChanges();
+    ASSERT_TRUE(changes.empty());
+    registry.destroyEntity(second);
+    registry.removeComponent<Health>(first);
+    ASSERT_EQ(std::vector(changes.removed().begin(), changes.removed().end()), (std::vector{ second, first }));
+    ASSERT_TRUE(changes.added().empty());
+
+    // the identifier of the destroyed entity gets recycled within the same frame
+    const auto recycled = registry.createEntity(Health{ 3 });
+    ASSERT_EQ(Registry::getIdentifierBitsFromEntity(recycled), Registry::getIdentifierBitsFromEntity(second));
+    ASSERT_EQ(std::vector(changes.added().begin(), changes.added().end()), std::vector{ recycled });
+}
+
+TEST(RegistryTests, Query_TracksMatchesIncrementally) {
+    Registry registry;
+    std::vector<Entity> entities;
+    for (int i = 0; i < 12; ++i) {
+        entities.push_back(registry.createEntity(Health{ i }, Mana{ i }));
+    }
+    registry.attachComponent(entities[0], Position{});
+    const auto query = registry.registerQuery<Health, Mana>(Without<Position>{});
+    ASSERT_EQ((registry.registerQuery<Health, Mana>(Without<Position>{}).index()), query.index());
+    ASSERT_EQ(registry.numMatches(query), 11);
+
+    registry.attachComponent(entities[1], Position{});
+    registry.removeComponent<Mana>(entities[2]);
+    registry.destroyEntity(entities[3]);
+    registry.removeComponent<Position>(entities[0]);
+    const auto created = registry.createEntity(Mana{ 100 }, Health{ 100 });
+    ASSERT_EQ(registry.numMatches(query), 10);
+
+    std::vector<Entity> visited;
+    for (auto&& [entity, health, mana] : registry.queryMutable(query)) {
+        ASSERT_EQ(health.value, mana.value);
+        visited.push_back(entity);
+    }
+    std::vector<Entity> expected{ entities[0], created };
+    expected.insert(expected.end(), entities.begin() + 4, entities.end());
+    std::sort(visited.begin(), visited.end());
+    std::sort(expected.begin(), expected.end());
+    ASSERT_EQ(visited, expected);
+
+    int sum{ 0 };
+    registry.each(query, [&sum](const Health& health, const Mana&) { sum += health.value; });
+    ASSERT_EQ(sum, 100 + (4 + 5 + 6 + 7 + 8 + 9 + 10 + 11));
+}
+
+struct EnemyTag { };
+
+TEST(RegistryTests, TagComponents_WorkInViewsAndOwningGroups) {
+    Registry registry;
+    registry.registerGroup<Health, EnemyTag>();
+    for (int i = 0; i < 10; ++i) {
+        const auto entity = registry.createEntity(Health{ i });
+        if (i % 2 == 0) {
+            registry.attachComponent(entity, EnemyTag{});
+        }
+    }
+    int count{ 0 };
+    for (auto&& [entity, health, tag] : registry.group<Health, EnemyTag>()) {
+        ASSERT_EQ(health.value % 2, 0);
+        ++count;
+    }
+    ASSERT_EQ(count, 5);
+    ASSERT_EQ(ranges::distance(registry.components<EnemyTag, Health>()), 5);
+}
+
+struct RegisteredComponent {
+    int value;
+};
+
+template<>
+struct c2k::RegisteredTypeIdentifier<RegisteredComponent> {
+    static constexpr std::size_t value = TypeIdentifier::numRegisteredIdentifiers - 1;
+};
+
+TEST(RegistryTests, TypeIdentifiers_RegisteredTypesAndStableHashes) {
+    static_assert(TypeList<Position, Velocity, Health>::indexOf<Health> == 2);
+    static_assert(TypeIdentifier::hash<Position>() == TypeIdentifier::hash<Position>());
+    static_assert(TypeIdentifier::hash<Position>() != TypeIdentifier::hash<Velocity>());
+    static_assert(TypeIdentifier::name<Position>().ends_with("Position"));
+    ASSERT_EQ(TypeIdentifier::get<RegisteredComponent>(), TypeIdentifier::numRegisteredIdentifiers - 1);
+    ASSERT_EQ(TypeIdentifier::get<TransformComponent>(), EngineComponentTypes::indexOf<TransformComponent>);
+
+    Registry registry;
+    const auto entity = registry.createEntity(RegisteredComponent{ 42 }, Position{ 1.0f, 2.0f });
+    ASSERT_TRUE(registry.componentSignature(entity).test(TypeIdentifier::numRegisteredIdentifiers - 1));
+    ASSERT_EQ(registry.component<RegisteredComponent>(entity)->value, 42);
+}
+
+TEST(RegistryEntityCreationAndDestructionFixture, GenerationsWrapWithoutChangingTheIdentifier) {
+    Registry registry;
+    const auto first = registry.createEntity();
+    registry.destroyEntity(first);
+    // more recycles than there are generations in the default entity layout
+    for (int i = 0; i < 5000; ++i) {
+        const auto entity = registry.createEntity();
+        ASSERT_EQ(Registry::getIdentifierBitsFromEntity(entity), Registry::getIdentifierBitsFromEntity(first));
+        registry.destroyEntity(entity);
+    }
+    ASSERT_EQ(registry.numEntities(), 1);
+    ASSERT_FALSE(registry.isEntityAlive(invalidEntity));
+}
+
+struct Particle {
+    float lifeTime{ 0.0f };
+    float velocity{ 0.0f };
+    int id{ 0 };
+};
+
+template<>
+struct c2k::StructOfArrays<Particle> {
+    static constexpr std::tuple members{ &Particle::lifeTime, &Particle::velocity, &Particle::id };
+
+    template<bool isConst>
+    struct Reference {
+        ColumnReference<float, isConst> lifeTime;
+        ColumnReference<float, isConst> velocity;
+        ColumnReference<int, isConst> id;
+    };
+};
+
+TEST(RegistryTests, StructOfArrays_StoresEveryMemberInItsOwnColumn) {
+    Registry registry;
+    ASSERT_TRUE(registry.column<&Particle::lifeTime>().empty());
+    std::vector<Entity> entities;
+    for (int i = 0; i < 10; ++i) {
+        entities.push_back(registry.createEntity(Particle{ static_cast<float>(10 - i), 1.0f, i }, Position{}));
+    }
+    registry.destroyEntity(entities[3]);
+
+    const auto lifeTimes = registry.columnMutable<&Particle::lifeTime>();
+    ASSERT_EQ(lifeTimes.size(), 9);
+    ASSERT_EQ(reinterpret_cast<std::uintptr_t>(lifeTimes.data()) % StructOfArraysImpl::columnAlignment, 0);
+    for (auto& lifeTime : lifeTimes) {
+        lifeTime -= 0.5f;
+    }
+    ASSERT_EQ(registry.component<Particle>(entities[0])->lifeTime, 9.5f);
+    ASSERT_EQ(registry.component<Particle>(entities[9])->id, 9);
+
+    registry.componentMutable<Particle>(entities[1])->velocity = 2.0f;
+    registry.each<Particle, Position>([](auto& particle, Position& position) { position.x += particle.velocity; });
+    for (auto&& [entity, particle, position] : registry.components<Particle, Position>()) {
+        ASSERT_EQ(position.x, particle.velocity);
+        ASSERT_EQ(entities[static_cast<std::size_t>(particle.id)], entity);
+    }
+
+    registry.sort<Particle>([](const Particle& lhs, const Particle& rhs) { return lhs.id < rhs.id; });
+    const auto ids = registry.column<&Particle::id>();
+    ASSERT_TRUE(std::is_sorted(ids.begin(), ids.end()));
+    ASSERT_EQ(registry.component<Particle>(entities[9])->lifeTime, 0.5f);
+
+    const auto snapshot = registry.snapshot();
+    registry.componentMutable<Particle>(entities[0])->id = 42;
+    registry.destroyEntity(entities[5]);
+    ASSERT_TRUE(registry.restore(snapshot));
+    ASSERT_EQ(registry.component<Particle>(entities[0])->id, 0);
+    ASSERT_EQ(registry.component<Particle>(entities[5])->lifeTime, 4.5f);
+    ASSERT_EQ(registry.column<&Particle::velocity>().size(), 9);
+}
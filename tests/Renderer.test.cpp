@@ -0,0 +1,216 @@
+//
+// Created by coder2k on 13.12.2021.
+//
+
+#include <Renderer.hpp>
+#include <RecordingRenderBackend.hpp>
+#include <gtest/gtest.h>
+#include <memory>
+#include <utility>
+#include <vector>
+
+using namespace c2k;
+
+namespace {
+    constexpr WindowSize framebufferSize{ 800, 600 };
+
+    struct RecordingRenderer {
+        explicit RecordingRenderer(std::size_t numTextureSlots = 16)
+            : RecordingRenderer{ std::make_unique<RecordingRenderBackend>(numTextureSlots) } { }
+
+        explicit RecordingRenderer(std::unique_ptr<RecordingRenderBackend> recordingBackend)
+            : backend{ *recordingBackend },
+              renderer{ std::move(recordingBackend) } { }
+
+        RecordingRenderBackend& backend;// owned by the renderer
+        Renderer renderer;
+    };
+}// namespace
+
+TEST(RendererTests, QuadsWithTheSameShader_AreDrawnInASingleBatch) {
+    RecordingRenderer recording;
+    auto& shader = recording.backend.createShaderProgram();
+    const auto& firstTexture = recording.backend.createTexture();
+    const auto& secondTexture = recording.backend.createTexture();
+    recording.renderer.beginFrame(glm::mat4{ 1.0f }, framebufferSize);
+    for (int i = 0; i < 10; ++i) {
+        recording.renderer.drawQuad(glm::vec3{ static_cast<float>(i), 0.0f, 0.0f }, 0.0f, glm::vec2{ 1.0f }, shader,
+                                    i % 2 == 0 ? firstTexture : secondTexture);
+    }
+    recording.renderer.endFrame();
+
+    const auto& drawCalls = recording.backend.drawCalls();
+    ASSERT_EQ(drawCalls.size(), 1);
+    ASSERT_EQ(drawCalls.front().indices.size(), 60);
+    ASSERT_EQ(drawCalls.front().vertices<Renderer::VertexData>().size(), 40);
+    ASSERT_EQ(drawCalls.front().textureNames.size(), 2);
+    ASSERT_EQ(recording.backend.count(RecordingRenderBackend::CommandType::BindShaderProgram), 1);
+    ASSERT_EQ(recording.renderer.stats().numBatches, 1);
+    ASSERT_EQ(recording.renderer.stats().numTriangles, 20);
+}
+
+TEST(RendererTests, RunningOutOfTextureSlots_StartsANewBatch) {
+    RecordingRenderer recording{ 2 };
+    auto& shader = recording.backend.createShaderProgram();
+    std::vector<const Texture*> textures;
+    for (int i = 0; i < 3; ++i) {
+        textures.push_back(&recording.backend.createTexture());
+    }
+    recording.renderer.beginFrame(glm::mat4{ 1.0f }, framebufferSize);
+    for (const auto texture : textures) {
+        recording.renderer.drawQuad(glm::vec3{ 0.0f }, 0.0f, glm::vec2{ 1.0f }, shader, *texture);
+    }
+    recording.renderer.endFrame();
+
+    const auto& drawCalls = recording.backend.drawCalls();
+    ASSERT_EQ(drawCalls.size(), 2);
+    ASSERT_EQ(drawCalls[0].indices.size(), 12);
+    ASSERT_EQ(drawCalls[1].indices.size(), 6);
+    ASSERT_EQ(drawCalls[0].textureNames.size(), 2);
+    ASSERT_NE(drawCalls[1].textureNames.front(), drawCalls[0].textureNames.front());
+    ASSERT_NE(drawCalls[1].textureNames.front(), drawCalls[0].textureNames.back());
+    ASSERT_EQ(recording.renderer.stats().numBatches, 2);
+}
+
+TEST(RendererTests, DifferentShaders_AreDrawnInSeparateBatches) {
+    RecordingRenderer recording;
+    auto& firstShader = recording.backend.createShaderProgram();
+    auto& secondShader = recording.backend.createShaderProgram();
+    const auto& texture = recording.backend.createTexture();
+    recording.renderer.beginFrame(glm::mat4{ 1.0f }, framebufferSize);
+    recording.renderer.drawQuad(glm::vec3{ 0.0f }, 0.0f, glm::vec2{ 1.0f }, secondShader, texture);
+    recording.renderer.drawQuad(glm::vec3{ 0.0f }, 0.0f, glm::vec2{ 1.0f }, firstShader, texture);
+    recording.renderer.drawQuad(glm::vec3{ 0.0f }, 0.0f, glm::vec2{ 1.0f }, secondShader, texture);
+    recording.renderer.endFrame();
+
+    const auto& drawCalls = recording.backend.drawCalls();
+    ASSERT_EQ(drawCalls.size(), 2);
+    ASSERT_LT(drawCalls[0].shaderProgramName, drawCalls[1].shaderProgramName);
+    ASSERT_EQ(drawCalls[0].indices.size(), 6);
+    ASSERT_EQ(drawCalls[1].indices.size(), 12);
+}
+
+TEST(RendererTests, BatchesExceeding16BitIndices_AreSplit) {
+    RecordingRenderer recording;
+    auto& shader = recording.backend.createShaderProgram();
+    const auto& texture = recording.backend.createTexture();
+    constexpr std::size_t numQuads = 65'536 / 4 + 1;
+    recording.renderer.beginFrame(glm::mat4{ 1.0f }, framebufferSize);
+    for (std::size_t i = 0; i < numQuads; ++i) {
+        recording.renderer.drawQuad(glm::vec3{ 0.0f }, 0.0f, glm::vec2{ 1.0f }, shader, texture);
+    }
+    recording.renderer.endFrame();
+
+    const auto& drawCalls = recording.backend.drawCalls();
+    ASSERT_EQ(drawCalls.size(), 2);
+    ASSERT_EQ(drawCalls[0].vertices<Renderer::VertexData>().size(), 65'536);
+    ASSERT_EQ(drawCalls[0].indices.back(), 65'535);
+    ASSERT_EQ(drawCalls[1].indices.size(), 6);
+}
+
+TEST(RendererTests, VertexData_ContainsTheTransformedCorners) {
+    RecordingRenderer recording;
+    auto& shader = recording.backend.createShaderProgram();
+    const auto& texture = recording.backend.createTexture();
+    const Rect textureRect{ .left{ 0.25f }, .bottom{ 0.5f }, .right{ 0.75f }, .top{ 1.0f } };
+    const Color color{ 1.0f, 0.5f, 0.25f, 1.0f };
+    recording.renderer.beginFrame(glm::mat4{ 1.0f }, framebufferSize);
+    recording.renderer.drawQuad(glm::vec3{ 10.0f, 20.0f, 0.0f }, 0.0f, glm::vec2{ 2.0f, 3.0f }, shader, texture,
+                                textureRect, color);
+    recording.renderer.endFrame();
+
+    const auto& drawCall = recording.backend.drawCalls().front();
+    ASSERT_EQ(drawCall.indexType, GL_UNSIGNED_SHORT);
+    ASSERT_EQ(drawCall.indices, (std::vector<GLuint>{ 0, 1, 2, 0, 2, 3 }));
+    const auto vertices = drawCall.vertices<Renderer::VertexData>();
+    ASSERT_EQ(vertices.size(), 4);
+    const std::vector<glm::vec3> expectedPositions{ { 8.0f, 17.0f, 0.0f },
+                                                    { 12.0f, 17.0f, 0.0f },
+                                                    { 12.0f, 23.0f, 0.0f },
+                                                    { 8.0f, 23.0f, 0.0f } };
+    const std::vector<glm::vec2> expectedTexCoords{
+        { 0.25f, 0.5f }, { 0.75f, 0.5f }, { 0.75f, 1.0f }, { 0.25f, 1.0f }
+    };
+    for (std::size_t i = 0; i < vertices.size(); ++i) {
+        ASSERT_EQ(vertices[i].position, expectedPositions[i]);
+        ASSERT_EQ(vertices[i].texCoords, glm::packUnorm2x16(expectedTexCoords[i]));
+        ASSERT_EQ(vertices[i].color, glm::packUnorm4x8(color));
+        ASSERT_EQ(vertices[i].texIndex, 0U);
+    }
+}
+
+TEST(RendererTests, TranslucentQuads_AreDrawnBackToFront) {
+    RecordingRenderer recording;
+    auto& shader = recording.backend.createShaderProgram();
+    const auto& texture = recording.backend.createTexture();
+    const Color translucent{ 1.0f, 1.0f, 1.0f, 0.5f };
+    recording.renderer.beginFrame(glm::mat4{ 1.0f }, framebufferSize);
+    for (const auto depth : { 0.5f, -0.5f, 0.0f }) {
+        recording.renderer.drawQuad(glm::vec3{ 0.0f, 0.0f, depth }, 0.0f, glm::vec2{ 1.0f }, shader, texture,
+                                    Rect::unit(), translucent);
+    }
+    recording.renderer.endFrame();
+
+    const auto& drawCalls = recording.backend.drawCalls();
+    ASSERT_EQ(drawCalls.size(), 1);
+    const auto vertices = drawCalls.front().vertices<Renderer::VertexData>();
+    ASSERT_EQ(vertices.size(), 12);
+    ASSERT_EQ(vertices[0].position.z, -0.5f);
+    ASSERT_EQ(vertices[4].position.z, 0.0f);
+    ASSERT_EQ(vertices[8].position.z, 0.5f);
+}
+
+TEST(RendererTests, HigherLayers_AreDrawnAfterLowerLayers) {
+    RecordingRenderer recording;
+    auto& firstShader = recording.backend.createShaderProgram();
+    auto& secondShader = recording.backend.createShaderProgram();
+    const auto& texture = recording.backend.createTexture();
+    recording.renderer.beginFrame(glm::mat4{ 1.0f }, framebufferSize);
+    recording.renderer.drawQuad(glm::vec3{ 0.0f }, 0.0f, glm::vec2{ 1.0f }, firstShader, texture, Rect::unit(),
+                                Color::white(), 1);
+    recording.renderer.drawQuad(glm::vec3{ 0.0f }, 0.0f, glm::vec2{ 1.0f }, secondShader, texture, Rect::unit(),
+                                Color::white(), 0);
+    recording.renderer.drawQuad(glm::vec3{ 0.0f }, 0.0f, glm::vec2{ 1.0f }, firstShader, texture);
+    recording.renderer.endFrame();
+
+    const auto& drawCalls = recording.backend.drawCalls();
+    ASSERT_EQ(drawCalls.size(), 3);
+    ASSERT_EQ(drawCalls[0].shaderProgramName, drawCalls[2].shaderProgramName);
+    ASSERT_NE(drawCalls[0].shaderProgramName, drawCalls[1].shaderProgramName);
+    ASSERT_EQ(drawCalls[2].indices.size(), 6);
+}
+
+TEST(RendererTests, InstancedMode_UploadsOneInstancePerQuad) {
+    auto backend = std::make_unique<RecordingRenderBackend>();
+    auto& recordingBackend = *backend;
+    Renderer renderer{ std::move(backend), Renderer::Mode::Instanced };
+    auto& shader = recordingBackend.createShaderProgram();
+    const auto& firstTexture = recordingBackend.createTexture();
+    const auto& secondTexture = recordingBackend.createTexture();
+    const Rect textureRect{ .left{ 0.25f }, .bottom{ 0.5f }, .right{ 0.75f }, .top{ 1.0f } };
+    renderer.beginFrame(glm::mat4{ 1.0f }, framebufferSize);
+    renderer.drawQuad(glm::vec3{ 10.0f, 20.0f, 0.5f }, 0.0f, glm::vec2{ 2.0f, 3.0f }, shader, firstTexture,
+                      textureRect, Color{ 1.0f, 0.0f, 0.0f, 1.0f });
+    renderer.drawQuad(glm::vec3{ 0.0f }, 0.0f, glm::vec2{ 1.0f }, shader, secondTexture);
+    renderer.drawQuad(glm::vec3{ 0.0f }, 0.0f, glm::vec2{ 1.0f }, shader, firstTexture);
+    renderer.endFrame();
+
+    ASSERT_EQ(recordingBackend.count(RecordingRenderBackend::CommandType::SubmitVertexData), 0);
+    const auto& drawCalls = recordingBackend.drawCalls();
+    ASSERT_EQ(drawCalls.size(), 1);
+    ASSERT_EQ(drawCalls.front().numInstances, 3);
+    ASSERT_EQ(drawCalls.front().textureNames.size(), 2);
+    const auto instances = drawCalls.front().instances<Renderer::InstanceData>();
+    ASSERT_EQ(instances.size(), 3);
+    const auto& instance = instances.front();
+    ASSERT_EQ(instance.transformedX, (glm::vec2{ 2.0f, 0.0f }));
+    ASSERT_EQ(instance.transformedY, (glm::vec2{ 0.0f, 3.0f }));
+    ASSERT_EQ(instance.translation, (glm::vec3{ 10.0f, 20.0f, 0.5f }));
+    ASSERT_EQ(instance.textureRect.left, textureRect.left);
+    ASSERT_EQ(instance.textureRect.top, textureRect.top);
+    ASSERT_EQ(instance.color, 0xFF0000FFU);
+    ASSERT_EQ(instance.texIndex, 0U);
+    ASSERT_EQ(instances[1].texIndex, 0U);
+    ASSERT_EQ(instances[2].texIndex, 1U);
+    ASSERT_EQ(renderer.stats().numTriangles, 6);
+}
@@ -23,8 +23,6 @@ struct Position {
     }
 };
 
-using Entity = uint32_t;
-
 TEST(SparseSetTests, CreateInstance) {
     SparseSet positions{ std::type_identity<Position>{}, 100 };
 }
@@ -60,4 +58,83 @@ TEST(SparseSetTests, TypeErasedIteration) {
         ++counter;
     }
     ASSERT_EQ(static_cast<const Health*>(healthValues.getTypeErased(10))->value, 101);
-}
\ No newline at end of file
+}
+
+TEST(SparseSetTests, SparsePagesAreAllocatedOnDemand) {
+    SparseSet healthValues{ std::type_identity<Health>{}, 10 };
+    healthValues.resize(10 * SparseSet::sparsePageSize);
+    ASSERT_EQ(healthValues.size(), 10 * SparseSet::sparsePageSize);
+    const auto farAway = static_cast<Entity>(7 * SparseSet::sparsePageSize + 3);
+    ASSERT_FALSE(healthValues.has(farAway));
+    healthValues.add(farAway, Health{ 7 });
+    healthValues.add(1, Health{ 1 });
+    ASSERT_TRUE(healthValues.has(farAway));
+    ASSERT_TRUE(healthValues.has(1));
+    ASSERT_FALSE(healthValues.has(farAway + 1));
+    ASSERT_FALSE(healthValues.has(static_cast<Entity>(3 * SparseSet::sparsePageSize)));
+    healthValues.remove(1);
+    ASSERT_FALSE(healthValues.has(1));
+    ASSERT_EQ(healthValues.get<Health>(farAway).value, 7);
+    ASSERT_EQ(healthValues.elementCount(), 1);
+}
+
+TEST(SparseSetTests, Sort_PermutesElementsAndSparseEntries) {
+    for (const auto algorithm : { SortAlgorithm::Standard, SortAlgorithm::Insertion }) {
+        SparseSet healthValues{ std::type_identity<Health>{}, 100 };
+        for (Entity i = 0; i < 100; ++i) {
+            healthValues.add(i, Health{ static_cast<int>((i * 37) % 100) });
+        }
+        healthValues.sort<Health>([](const Health& lhs, const Health& rhs) { return lhs.value < rhs.value; },
+                                  algorithm);
+        const auto elements = healthValues.elements<Health>();
+        ASSERT_TRUE(std::is_sorted(elements.begin(), elements.end(),
+                                   [](const Health& lhs, const Health& rhs) { return lhs.value < rhs.value; }));
+        for (Entity i = 0; i < 100; ++i) {
+            ASSERT_EQ(healthValues.get<Health>(i).value, static_cast<int>((i * 37) % 100));
+            ASSERT_EQ(*(healthValues.indicesBegin() + static_cast<std::ptrdiff_t>(healthValues.denseIndex(i))), i);
+        }
+    }
+}
+
+TEST(SparseSetTests, Sort_InsertionIsLinearOnSortedData) {
+    SparseSet healthValues{ std::type_identity<Health>{}, 100 };
+    for (Entity i = 0; i < 100; ++i) {
+        healthValues.add(i, Health{ static_cast<int>(i) });
+    }
+    std::size_t numComparisons{ 0 };
+    const auto compare = [&numComparisons](const Health& lhs, const Health& rhs) {
+        ++numComparisons;
+        return lhs.value < rhs.value;
+    };
+    healthValues.sort<Health>(compare, SortAlgorithm::Insertion);
+    ASSERT_EQ(numComparisons, 99);
+
+    // moving a single element to the front only costs the additional comparisons with its predecessors
+    healthValues.getMutable<Health>(50).value = -1;
+    numComparisons = 0;
+    healthValues.sort<Health>(compare, SortAlgorithm::Insertion);
+    ASSERT_EQ(numComparisons, 99 + 49);
+    ASSERT_EQ(healthValues.elements<Health>().begin()->value, -1);
+    ASSERT_EQ(*healthValues.indicesBegin(), 50);
+}
+
+struct PlayerTag { };
+
+TEST(SparseSetTests, TagStorage_OnlyStoresIndices) {
+    SparseSet tags{ std::type_identity<PlayerTag>{}, 100, 16 };
+    ASSERT_TRUE(tags.isTagStorage());
+    for (Entity i = 0; i < 10; ++i) {
+        tags.add(i * 3, PlayerTag{});
+    }
+    tags.remove(6);
+    ASSERT_EQ(tags.elementCount(), 9);
+    ASSERT_FALSE(tags.has(6));
+    ASSERT_TRUE(tags.has(9));
+    ASSERT_EQ(&tags.get<PlayerTag>(9), &tags.get<PlayerTag>(27));
+    ASSERT_EQ(ranges::distance(tags.elements<PlayerTag>()), 9);
+    ASSERT_EQ(ranges::distance(tags.typeErasedElements()), 9);
+    ASSERT_EQ(std::distance(tags.begin(), tags.end()), 9);
+    tags.clear();
+    ASSERT_EQ(tags.elementCount(), 0);
+    ASSERT_EQ(ranges::distance(tags.elements<PlayerTag>()), 0);
+}
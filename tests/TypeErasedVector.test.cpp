@@ -162,4 +162,27 @@ TEST(TypeErasedVectorTests, TypeErasedIteration) {
                                  transform([](auto ptr) { return *static_cast<int const*>(ptr); }))) {
         ASSERT_EQ(pair.first, pair.second);
     }
-}
\ No newline at end of file
+}
+
+TEST(TypeErasedVectorTests, SwapRemove) {
+    auto numbers = TypeErasedVector::forType<int>();
+    auto words = TypeErasedVector::forType<std::string>();
+    for (int i = 0; i < 4; ++i) {
+        numbers.push_back(i);
+        words.push_back(std::to_string(i));
+    }
+    numbers.swapRemove(1);
+    words.swapRemove(1);
+    ASSERT_EQ(numbers.size(), 3);
+    ASSERT_EQ(words.size(), 3);
+    ASSERT_EQ(numbers.get<int>(1), 3);
+    ASSERT_EQ(words.get<std::string>(1), "3");
+    numbers.swapRemove(2);
+    words.swapRemove(2);
+    ASSERT_EQ(numbers.size(), 2);
+    ASSERT_EQ(words.size(), 2);
+    ASSERT_EQ(numbers.get<int>(0), 0);
+    ASSERT_EQ(words.get<std::string>(0), "0");
+    ASSERT_EQ(numbers.get<int>(1), 3);
+    ASSERT_EQ(words.get<std::string>(1), "3");
+}